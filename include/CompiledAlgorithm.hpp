@@ -0,0 +1,115 @@
+#pragma once
+
+#include "Cube.hpp"
+#include "CubeMoveEngine.hpp"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace cube
+{
+constexpr int NumStickerSlots = EnumToInt(eCubeFace::NumFaces) * FaceStride;
+
+/**
+ * @brief      A sequence of moves reduced to the single sticker permutation it performs, so the
+ * whole sequence can be applied to a Cube in one step (see Cube::ExecuteAlgorithm). The individual
+ * moves are kept so callers can still record them.
+ *
+ * Slots are indexed as face * FaceStride + index within the face, padding included. Padding slots
+ * always map to themselves.
+ */
+class CompiledAlgorithm
+{
+public:
+   /**
+    * @brief      Creates an empty algorithm, applying it does nothing.
+    */
+   CompiledAlgorithm();
+
+   /**
+    * @brief      Compiles the given moves.
+    *
+    * @param[in]  moves  The moves
+    */
+   explicit CompiledAlgorithm(const std::vector<eCubeMove>& moves);
+
+   /**
+    * @brief      Compiles the given moves.
+    *
+    * @param[in]  moves        The moves
+    * @param[in]  numMoves     The number moves
+    * @param[in]  recordMoves  False to only keep the permutation, for sequences too long to copy
+    */
+   CompiledAlgorithm(const eCubeMove* moves, size_t numMoves, bool recordMoves = true);
+
+   /**
+    * @brief      Appends another algorithm, the result performs this one then the other.
+    *
+    * @param[in]  other  The other
+    */
+   void Append(const CompiledAlgorithm& other);
+
+   /**
+    * @brief      Computes the algorithm undoing this one by inverting the permutation. The
+    * recorded moves are replaced by their reverse.
+    *
+    * @return     The inverse algorithm.
+    */
+   CompiledAlgorithm Inverse() const;
+
+   /**
+    * @return     The moves this algorithm was compiled from.
+    */
+   inline const std::vector<eCubeMove>& GetMoves() const
+   {
+      return mMoves;
+   }
+
+   /**
+    * @brief      Returns where the sticker ending up in the given slot comes from. After the
+    * algorithm is applied, slot holds what was in GetSourceSlot(slot) before.
+    *
+    * @param[in]  slot  The slot
+    *
+    * @return     The source slot.
+    */
+   inline int GetSourceSlot(int slot) const
+   {
+      return mSourceSlots[slot];
+   }
+
+   /**
+    * @brief      Returns where the sticker in the given slot goes, the inverse of GetSourceSlot.
+    *
+    * @param[in]  slot  The slot
+    *
+    * @return     The destination slot.
+    */
+   inline int GetDestinationSlot(int slot) const
+   {
+      return mDestinationSlots[slot];
+   }
+
+   /**
+    * @return     The precomputed byte shuffles used by the shuffle engine.
+    */
+   inline const tPermutationShuffle& GetShuffle() const
+   {
+      return mShuffle;
+   }
+
+   bool operator==(const CompiledAlgorithm& other) const
+   {
+      return mSourceSlots == other.mSourceSlots;
+   }
+
+private:
+   void Compile();
+
+   std::vector<eCubeMove> mMoves;
+   std::array<uint8_t, NumStickerSlots> mSourceSlots;
+   std::array<uint8_t, NumStickerSlots> mDestinationSlots;
+   tPermutationShuffle mShuffle;
+};
+}   // namespace cube
@@ -0,0 +1,138 @@
+#pragma once
+
+#include "Cube.hpp"
+#include "CubieCube.hpp"
+
+#include <cstdint>
+
+namespace cube
+{
+// Twists of the first 7 corners, the last one follows from them.
+constexpr int NumCornerTwists = 2187;
+// Flips of the first 11 edges, the last one follows from them.
+constexpr int NumEdgeFlips = 2048;
+// Ways to choose the 4 slots holding the FR, FL, BL and BR edges out of 12.
+constexpr int NumUDSlices = 495;
+constexpr int NumCornerPermutations = 40320;
+constexpr uint32_t NumEdgePermutations = 479001600;
+
+/**
+ * @brief      Cube model for search based solvers. The state is reduced to a few integer
+ * coordinates, each with a move table giving its value after every move, so executing a move is
+ * one lookup per coordinate instead of touching stickers or pieces.
+ *
+ * Coordinates describe the slots of a CubieCube and are 0 for the solved cube:
+ *  - CornerTwist: the twists of the corners URF to DBL, base 3.
+ *  - EdgeFlip: the flips of the edges UR to BL, base 2.
+ *  - UDSlice: which slots hold the middle layer edges, ranked as a combination.
+ *  - CornerPermutation: the rank of the corner permutation (Lehmer code).
+ *
+ * The edge permutation has too many values for a move table. Its rank is available through
+ * GetEdgePermutation and SetEdgePermutation to convert states, not as a tracked coordinate.
+ *
+ * The move tables are built once, when the first CoordinateCube is constructed, and are read only
+ * afterwards so any number of threads can share them. Call PrepareMoveTables up front to keep the
+ * build out of a timed or multi threaded section.
+ */
+class CoordinateCube
+{
+public:
+   /**
+    * @brief      Standard constructor. The cube starts solved.
+    */
+   CoordinateCube();
+
+   /**
+    * @brief      Computes the coordinates of the given cubie state.
+    *
+    * @param[in]  cubieCube  The cubie state
+    */
+   explicit CoordinateCube(const CubieCube& cubieCube);
+
+   /**
+    * @brief      Computes the coordinates of the given cube. The cube must hold a valid set of
+    * pieces.
+    *
+    * @param[in]  cube  The cube
+    */
+   explicit CoordinateCube(const Cube& cube);
+
+   /**
+    * @brief      Builds the move tables if they aren't built yet.
+    */
+   static void PrepareMoveTables();
+
+   /**
+    * @brief      Returns true if every tracked coordinate is at its solved value. The edge
+    * permutation isn't tracked, see the class description, so this is also true for cubes that
+    * only have their edges permuted (a U perm for example). It does not mean the cube is solved.
+    *
+    * @return     True if the coordinates are solved, False otherwise.
+    */
+   bool AreCoordinatesSolved() const;
+
+   /**
+    * @brief      Executes a single move.
+    *
+    * @param[in]  move  The move
+    */
+   void ExecuteMove(eCubeMove move);
+
+   /**
+    * @brief      Executes a series of moves
+    *
+    * @param      move      The move
+    * @param[in]  numMoves  The number moves
+    */
+   void ExecuteMoves(const eCubeMove* moves, size_t numMoves);
+
+   inline int GetCornerTwist() const
+   {
+      return mCornerTwist;
+   }
+
+   inline int GetEdgeFlip() const
+   {
+      return mEdgeFlip;
+   }
+
+   inline int GetUDSlice() const
+   {
+      return mUDSlice;
+   }
+
+   inline int GetCornerPermutation() const
+   {
+      return mCornerPermutation;
+   }
+
+   /**
+    * @brief      Coordinate conversions. Each getter reads one coordinate out of a cubie state.
+    * Each setter overwrites the part of the cubie state the coordinate describes so that the
+    * getter returns the given value; slots the coordinate doesn't determine are filled in slot
+    * order.
+    */
+   static int GetCornerTwist(const CubieCube& cubieCube);
+   static void SetCornerTwist(CubieCube& cubieCube, int twist);
+
+   static int GetEdgeFlip(const CubieCube& cubieCube);
+   static void SetEdgeFlip(CubieCube& cubieCube, int flip);
+
+   static int GetUDSlice(const CubieCube& cubieCube);
+   static void SetUDSlice(CubieCube& cubieCube, int slice);
+
+   static int GetCornerPermutation(const CubieCube& cubieCube);
+   static void SetCornerPermutation(CubieCube& cubieCube, int permutation);
+
+   static uint32_t GetEdgePermutation(const CubieCube& cubieCube);
+   static void SetEdgePermutation(CubieCube& cubieCube, uint32_t permutation);
+
+   bool operator==(const CoordinateCube& other) const = default;
+
+private:
+   uint16_t mCornerTwist;
+   uint16_t mEdgeFlip;
+   uint16_t mUDSlice;
+   uint16_t mCornerPermutation;
+};
+}   // namespace cube
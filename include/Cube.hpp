@@ -2,19 +2,25 @@
 
 #include <array>
 #include <cassert>
+#include <cstdint>
+#include <functional>
 #include <ostream>
 #include <random>
+#include <span>
+#include <string_view>
 #include <vector>
 
 namespace cube
 {
+class CompiledAlgorithm;
+
 constexpr int CubeSize = 3;
 
 /**
  * @brief      Defines the valid colors on a cube.
  * The colors are specified on the cube such that color==face
  */
-enum class eCubeColor
+enum class eCubeColor : uint8_t
 {
    Yellow,
    White,
@@ -40,6 +46,17 @@ enum class eCubeFace
    NumFaces
 };
 
+/**
+ * @brief      The three axes of the cube. X goes through the right face, Y through the top face and Z
+ * through the front face.
+ */
+enum class eCubeAxis
+{
+   YAxis,
+   XAxis,
+   ZAxis
+};
+
 /**
  * @brief      Defines the valid moves that can be done on the cube.
  */
@@ -104,9 +121,94 @@ enum class eCubeMove
    NumMoves
 };
 
+/**
+ * @brief      The backends that can execute moves on a Cube.
+ */
+enum class eMoveEngine
+{
+   // Hand written sticker copies, works everywhere.
+   Scalar,
+   // One or two SSSE3 byte shuffles per face.
+   Shuffle,
+};
+
+/**
+ * @brief      The result of checking whether a cube can be solved, see Cube::CheckValidity.
+ */
+enum class eCubeValidity
+{
+   Valid,
+   // A sticker isn't a color, or some color doesn't cover exactly 9 stickers.
+   InvalidColors,
+   // The centers aren't arranged like on a real cube.
+   InvalidCenters,
+   // The stickers of some slot don't form a real piece.
+   InvalidPiece,
+   // The same piece appears twice.
+   DuplicatePiece,
+   // The corner twists don't add up, a single corner is twisted.
+   TwistedCorner,
+   // The edge flips don't add up, a single edge is flipped.
+   FlippedEdge,
+   // The corner and edge permutations have different parities, two pieces are swapped.
+   ParityError,
+};
+
+/**
+ * @brief      Why parsing a move notation stopped, see Cube::ParseMoveNotation.
+ */
+enum class eNotationError
+{
+   None,
+   // A token isn't a move, see IsNotationChar for how tokens are split.
+   InvalidMove,
+   // The moves don't fit in the given buffer.
+   BufferTooSmall,
+};
+
+/**
+ * @brief      The result of parsing a move notation into a buffer.
+ */
+struct tNotationResult
+{
+   // Moves written to the buffer, the ones before the error if there is one.
+   size_t NumMoves;
+   eNotationError Error;
+   // Where the token the error is about starts in the notation, and its length.
+   size_t ErrorOffset;
+   size_t ErrorLength;
+   // Invalid moves skipped over. Only the vector version of Cube::ParseMoveNotation goes on after
+   // an error, the error fields then describe the first one.
+   size_t NumSkippedMoves;
+};
+
+// Each face is padded to 16 one byte stickers so a face fits in a single SSE register.
 using SingleCubeFace = std::array<eCubeColor, 16>;
 using CubeFaceData = std::array<SingleCubeFace, static_cast<int>(eCubeFace::NumFaces)>;
 
+constexpr int FaceStride = static_cast<int>(std::tuple_size_v<SingleCubeFace>);
+
+// The corners and edges of the cube, the pieces tracked by the piece index.
+constexpr int NumTrackedPieces = 8 + 12;
+
+/**
+ * @brief      A copy of everything that changes when moves are executed on a Cube, see
+ * Cube::SaveSnapshot. Restoring it is a fixed size copy however many moves were made since.
+ */
+struct tCubeSnapshot
+{
+   alignas(16) CubeFaceData Stickers;
+   std::array<uint8_t, NumTrackedPieces> PieceSlots;
+   uint8_t Orientation;
+   bool HasPieceSlots;
+};
+
+// The number of ways a cube can be held, 6 faces on top times 4 faces in front.
+constexpr int NumOrientations = 24;
+
+// The symmetries of the cube: every orientation, plain and mirrored left to right.
+constexpr int NumSymmetries = 2 * NumOrientations;
+
 template <typename T> [[nodiscard]] constexpr int EnumToInt(T token)
 {
    return static_cast<int>(token);
@@ -140,6 +242,20 @@ public:
     */
    bool IsSolved();
 
+   /**
+    * @brief      Computes a 64 bit hash of the stickers as they are seen, suitable for hash
+    * tables keyed on cube states. Cubes comparing equal always hash the same.
+    *
+    * @return     The hash.
+    */
+   uint64_t Hash() const;
+
+   /**
+    * @brief      Two cubes are equal when every sticker seen at the same position has the same
+    * color, regardless of how they are stored or oriented internally.
+    */
+   bool operator==(const Cube& other) const;
+
    /**
     * @brief      Executes a single move.
     *
@@ -153,7 +269,183 @@ public:
     * @param      move      The move
     * @param[in]  numMoves  The number moves
     */
-   void ExecuteMoves(eCubeMove* move, size_t numMoves);
+   void ExecuteMoves(const eCubeMove* move, size_t numMoves);
+
+   /**
+    * @brief      Executes a series of moves. Moves are decoded in blocks, and each block runs on a
+    * local copy of the stickers through the move engine, so the checks and the dispatch done by
+    * ExecuteMove are paid once per block instead of once per move.
+    *
+    * @param[in]  moves  The moves
+    */
+   void ExecuteMoves(std::span<const eCubeMove> moves);
+
+   /**
+    * @brief      Executes a long series of moves using several threads. Each thread reduces its
+    * share of the moves to a single permutation, the permutations are composed and the result is
+    * applied once. Falls back to ExecuteMoves if the sequence is too short to be worth it.
+    *
+    * @param      moves       The moves
+    * @param[in]  numMoves    The number moves
+    * @param[in]  numThreads  The number of threads, 0 to use every hardware thread
+    */
+   void ExecuteMovesParallel(const eCubeMove* moves, size_t numMoves, unsigned numThreads = 0);
+
+   /**
+    * @brief      Enables or disables virtual rotations. When enabled, x, y and z only update the
+    * orientation the cube is held in, and every other move and lookup is remapped through it.
+    * Disabling folds the current orientation into the stickers.
+    *
+    * @param[in]  enabled  True to enable
+    */
+   void SetVirtualRotations(bool enabled);
+
+   /**
+    * @return     True if rotations are virtual.
+    */
+   inline bool GetVirtualRotations() const
+   {
+      return mVirtualRotations;
+   }
+
+   /**
+    * @return     The index of the orientation the stickers are viewed through, 0 when the stickers
+    * are stored as they are seen.
+    */
+   inline int GetOrientation() const
+   {
+      return mOrientation;
+   }
+
+   /**
+    * @brief      Physically applies the current orientation to the stickers and resets it. Doesn't
+    * change what any lookup returns.
+    */
+   void Flatten();
+
+   /**
+    * @brief      Enables or disables the piece index. When enabled, the cube keeps track of where
+    * every corner and edge is as moves are executed, so IsPieceAt and LocatePiece are constant
+    * time. Each move costs a little more while it's enabled.
+    *
+    * @param[in]  enabled  True to enable
+    */
+   void SetPieceTracking(bool enabled);
+
+   /**
+    * @return     True if the piece index is maintained.
+    */
+   inline bool GetPieceTracking() const
+   {
+      return mTrackPieces;
+   }
+
+   /**
+    * @brief      Returns true if the edge with the given colors has a sticker at the given position.
+    * The piece index must be enabled.
+    *
+    * @param[in]  color1  The first color of the piece
+    * @param[in]  color2  The second color of the piece
+    * @param[in]  face    The face
+    * @param[in]  x       The x coordinate
+    * @param[in]  y       The y coordinate
+    */
+   bool IsPieceAt(eCubeColor color1, eCubeColor color2, eCubeFace face, int x, int y) const;
+
+   /**
+    * @brief      Returns true if the corner with the given colors has a sticker at the given
+    * position. The piece index must be enabled.
+    */
+   bool IsPieceAt(eCubeColor color1, eCubeColor color2, eCubeColor color3, eCubeFace face, int x,
+      int y) const;
+
+   /**
+    * @brief      Finds where the reference sticker of the edge with the given colors is seen. The
+    * reference sticker is the one belonging on the top or bottom face, or on the front or back
+    * face for middle layer edges, which also tells how the piece is flipped. The piece index must
+    * be enabled.
+    *
+    * @param[in]  color1  The first color of the piece
+    * @param[in]  color2  The second color of the piece
+    * @param      face    The face
+    * @param      x       The x coordinate
+    * @param      y       The y coordinate
+    *
+    * @return     False if no such piece is on the cube.
+    */
+   bool LocatePiece(eCubeColor color1, eCubeColor color2, eCubeFace& face, int& x, int& y) const;
+
+   /**
+    * @brief      Finds where the reference sticker of the corner with the given colors is seen, the
+    * one belonging on the top or bottom face. See the edge version.
+    */
+   bool LocatePiece(eCubeColor color1, eCubeColor color2, eCubeColor color3, eCubeFace& face,
+      int& x, int& y) const;
+
+   /**
+    * @brief      Executes a whole precompiled algorithm as a single sticker permutation.
+    *
+    * @param[in]  algorithm  The algorithm
+    */
+   void ExecuteAlgorithm(const CompiledAlgorithm& algorithm);
+
+   /**
+    * @brief      Conjugates the cube by a symmetry: every sticker is moved to where the symmetry
+    * takes it and recolored with the color of the face the symmetry takes its face to. The
+    * result is an equivalent state, solved by the conjugated moves (see ConjugateMove).
+    *
+    * Symmetries 0 to NumOrientations - 1 are the orientations, 0 being the identity, the rest are
+    * the same orientations after mirroring left to right. The orientation is flattened.
+    *
+    * @param[in]  symmetry  The symmetry
+    */
+   void ApplySymmetry(int symmetry);
+
+   /**
+    * @brief      Replaces the cube with the representative of its symmetry class, the state with
+    * the lowest stickers (compared in face order) over every symmetry. Equivalent states always
+    * produce the same representative.
+    *
+    * @return     The symmetry that was applied, see ApplySymmetry.
+    */
+   int Canonicalize();
+
+   /**
+    * @return     The symmetry undoing the given one.
+    */
+   static int InverseSymmetry(int symmetry);
+
+   /**
+    * @brief      Maps a move to the move doing the same thing on a cube after ApplySymmetry. To
+    * apply a solution of the canonical state to the original one, map its moves through the
+    * inverse of the symmetry Canonicalize returned.
+    *
+    * @param[in]  move      The move
+    * @param[in]  symmetry  The symmetry
+    *
+    * @return     The conjugated move.
+    */
+   static eCubeMove ConjugateMove(eCubeMove move, int symmetry);
+
+   /**
+    * @brief      Returns true if the current CPU can run the given move engine.
+    *
+    * @param[in]  engine  The engine
+    */
+   static bool IsMoveEngineSupported(eMoveEngine engine);
+
+   /**
+    * @brief      Selects the engine used by every cube to execute moves. The fastest supported
+    * engine is selected by default.
+    *
+    * @param[in]  engine  The engine, must be supported
+    */
+   static void SetMoveEngine(eMoveEngine engine);
+
+   /**
+    * @return     The engine currently used to execute moves.
+    */
+   static eMoveEngine GetMoveEngine();
 
    /**
     * @brief      Solves the cube using the CFOP method.
@@ -163,7 +455,23 @@ public:
    /**
     * @return     True if the cube is solvable as it's currently configured.
     */
-   bool Validate();
+   bool Validate() const;
+
+   /**
+    * @return     Whether the cube is solvable, or the first reason found why it isn't.
+    */
+   eCubeValidity CheckValidity() const;
+
+   /**
+    * @brief      Checks whether the given stickers form a solvable cube. Colors are counted first,
+    * then the stickers are converted to pieces and their twist, flip and permutation parity are
+    * checked.
+    *
+    * @param[in]  faceData  The face data
+    *
+    * @return     Whether the cube is solvable, or the first reason found why it isn't.
+    */
+   static eCubeValidity CheckValidity(const CubeFaceData& faceData);
 
    /**
     * @brief      Returns the color at a given index of the cube.
@@ -175,9 +483,10 @@ public:
 
     * @return     The color state at the given position.
     */
-   inline eCubeColor GetState(eCubeFace face, int x, int y)
+   inline eCubeColor GetState(eCubeFace face, int x, int y) const
    {
-      return mCube[EnumToInt(face)][CubeDimsToIdx(x, y)];
+      int slot = GetStickerSlot(face, x, y);
+      return mCube[slot / FaceStride][slot % FaceStride];
    }
 
    /**
@@ -191,7 +500,108 @@ public:
     */
    inline void SetState(eCubeFace face, int x, int y, eCubeColor color)
    {
-      mCube[EnumToInt(face)][CubeDimsToIdx(x, y)] = color;
+      int slot = GetStickerSlot(face, x, y);
+      if (mTrackPieces)
+      {
+         SetTrackedSticker(slot, color);
+         return;
+      }
+
+      mCube[slot / FaceStride][slot % FaceStride] = color;
+   }
+
+   /**
+    * @return     The raw sticker data of every face. The cube must not be viewed through an
+    * orientation, see Flatten and CopyFaceData.
+    */
+   inline const CubeFaceData& GetFaceData() const
+   {
+      assert(mOrientation == 0 && "Raw sticker data is stored in a different orientation.");
+      return mCube;
+   }
+
+   /**
+    * @return     The raw sticker data of every face, as stored. It is seen through GetOrientation,
+    * see GetOrientationSlot.
+    */
+   inline const CubeFaceData& GetStoredFaceData() const
+   {
+      return mCube;
+   }
+
+   /**
+    * @brief      Returns where the sticker seen at the given position through an orientation is
+    * stored.
+    *
+    * @param[in]  orientation  The orientation, see GetOrientation
+    * @param[in]  face         The face
+    * @param[in]  x            The x coordinate
+    * @param[in]  y            The y coordinate
+    *
+    * @return     The stored slot, face * FaceStride + index within the face.
+    */
+   static inline int GetOrientationSlot(int orientation, eCubeFace face, int x, int y)
+   {
+      return sOrientationSlots[orientation][EnumToInt(face) * CubeSize * CubeSize + CubeDimsToIdx(x, y)];
+   }
+
+   /**
+    * @brief      Copies the sticker data of every face as it is seen through the current
+    * orientation.
+    *
+    * @param      faceData  The face data
+    */
+   void CopyFaceData(CubeFaceData& faceData) const;
+
+   /**
+    * @brief      Overwrites the raw sticker data of every face and resets the orientation.
+    *
+    * @param[in]  faceData  The face data
+    */
+   inline void SetFaceData(const CubeFaceData& faceData)
+   {
+      mCube = faceData;
+      mOrientation = 0;
+
+      if (mTrackPieces)
+      {
+         RebuildPieceIndex();
+      }
+   }
+
+   /**
+    * @brief      Saves the current state so it can be restored later. Settings such as virtual
+    * rotations and piece tracking are not part of the state.
+    *
+    * @param      snapshot  The snapshot
+    */
+   inline void SaveSnapshot(tCubeSnapshot& snapshot) const
+   {
+      snapshot.Stickers = mCube;
+      snapshot.PieceSlots = mPieceSlots;
+      snapshot.Orientation = mOrientation;
+      snapshot.HasPieceSlots = mTrackPieces;
+   }
+
+   /**
+    * @brief      Puts the cube back in the state saved in the snapshot.
+    *
+    * @param[in]  snapshot  The snapshot
+    */
+   inline void RestoreSnapshot(const tCubeSnapshot& snapshot)
+   {
+      assert((mVirtualRotations || snapshot.Orientation == 0) &&
+             "The snapshot is seen through an orientation, virtual rotations must be enabled.");
+
+      mCube = snapshot.Stickers;
+      mOrientation = snapshot.Orientation;
+      mPieceSlots = snapshot.PieceSlots;
+
+      // Tracking was turned on after the snapshot was taken.
+      if (mTrackPieces && !snapshot.HasPieceSlots)
+      {
+         RebuildPieceIndex();
+      }
    }
 
    /**
@@ -226,7 +636,7 @@ public:
     *
     * @return     The cube face.
     */
-   eCubeFace FaceOfColor(eCubeColor color)
+   eCubeFace FaceOfColor(eCubeColor color) const
    {
       for (int i = 0; i < EnumToInt(eCubeFace::NumFaces); i++)
       {
@@ -248,10 +658,10 @@ public:
     *
     * @return     The cube color.
     */
-   eCubeColor ColorOfFace(eCubeFace face)
+   eCubeColor ColorOfFace(eCubeFace face) const
    {
       // Return the color of the middle of the given face.
-      return mCube[EnumToInt(face)][CubeDimsToIdx(CubeSize / 2, CubeSize / 2)];
+      return GetState(face, CubeSize / 2, CubeSize / 2);
    }
 
    /**
@@ -269,19 +679,50 @@ public:
    /**
     * @brief      Converts the list of moves to a human readable string.
     *
-    * @param      outputStream  The stream to write data to
-    * @param      moves         The moves
+    * @param      outputStream       The stream to write data to
+    * @param      moves              The moves
+    * @param[in]  numMoves           The number moves
+    * @param[in]  includeSeparators  True to write "- " between groups of 5 moves
+    */
+   static void SerializeMoveList(std::ostream& outputStream, const eCubeMove* moves, size_t numMoves,
+      bool includeSeparators = false);
+
+   /**
+    * @brief      Writes the moves into a caller owned buffer without allocating. Stops before the
+    * first move that doesn't fit, GetMaxSerializedLength gives a size that always fits.
+    *
+    * @param[in]  moves              The moves
+    * @param      buffer             The buffer the characters are written to
+    * @param[in]  includeSeparators  True to write "- " between groups of 5 moves
+    *
+    * @return     The number of characters written.
+    */
+   static size_t SerializeMoveList(
+      std::span<const eCubeMove> moves, std::span<char> buffer, bool includeSeparators = false);
+
+   /**
+    * @brief      Creates a list of moves given a string of move notation. Invalid moves are
+    * skipped and reported in the result.
+    *
+    * @param[in]  moveNotation  The move notation
+    * @param      moves         The parsed moves are appended here
+    *
+    * @return     The number of moves appended, the first invalid move and how many were skipped.
     */
-   static void SerializeMoveList(
-      std::ostream& outputStream, eCubeMove* moves, size_t numMoves, bool includeSeparators = false);
+   static tNotationResult ParseMoveNotation(
+      std::string_view moveNotation, std::vector<eCubeMove>& moves);
 
    /**
-    * @brief      Creates a list of moves given a string of move notation.
+    * @brief      Parses moves into a caller owned buffer without allocating. Stops at the first
+    * invalid move or once the buffer is full, GetMaxNotationMoves gives a size that always fits.
     *
     * @param[in]  moveNotation  The move notation
-    * @param      moves         The moves
+    * @param      moves         The buffer the moves are written to
+    *
+    * @return     The number of moves written and the error, if any.
     */
-   static void ParseMoveNotation(const std::string& moveNotation, std::vector<eCubeMove>& moves);
+   static tNotationResult ParseMoveNotation(
+      std::string_view moveNotation, std::span<eCubeMove> moves);
 
    /**
     * @brief      Takes in a list of moves and produces the reverse of those moves.
@@ -295,40 +736,64 @@ public:
    /**
     * @brief      Generates a random sequence of moves for the scramble.
     */
-   static void GenerateScramble(std::vector<eCubeMove>& scramble, int numMoves, int seed)
-   {
-      std::random_device rd;
-      std::mt19937 engine(rd());
-      engine.seed(seed);
+   static void GenerateScramble(std::vector<eCubeMove>& scramble, int numMoves, int seed);
 
-      // Define the valid moves for a scramble
-      static std::vector<eCubeMove> validScrambleMoves
-      {
-         eCubeMove::Right, eCubeMove::Right2, eCubeMove::RightPrime,
-         eCubeMove::Left, eCubeMove::Left2, eCubeMove::LeftPrime,
-         eCubeMove::Up, eCubeMove::Up2, eCubeMove::UpPrime,
-         eCubeMove::Front, eCubeMove::Front2, eCubeMove::FrontPrime,
-      };
-
-      // Uniform integer distribution between 1 and 6 (like a die roll)
-      std::uniform_int_distribution<int> randomMovesGen(0, validScrambleMoves.size() - 1);
-
-      // Generate random sequence of moves.
-      int lastAxis = -1;
-      while (scramble.size() < numMoves)
-      {
-         int moveIdx = randomMovesGen(engine);
-         int moveAxis = moveIdx / 3;
+private:
+   /**
+    * @return     The hash of the given sticker data, see Hash.
+    */
+   static uint64_t HashFaceData(const CubeFaceData& faceData);
 
-         if (moveAxis != lastAxis)
-         {
-            scramble.push_back(static_cast<eCubeMove>(validScrambleMoves[moveIdx]));
-            lastAxis = moveAxis;
-         }
-      }
+   /**
+    * @return     Where the sticker seen at the given position is stored (face * FaceStride + index).
+    */
+   inline int GetStickerSlot(eCubeFace face, int x, int y) const
+   {
+      return GetOrientationSlot(mOrientation, face, x, y);
    }
 
-private:
-   CubeFaceData mCube;
+   /**
+    * @brief      Finds every tracked piece by scanning the stickers.
+    */
+   void RebuildPieceIndex();
+
+   /**
+    * @brief      Writes one stored sticker and updates the piece index for the position it belongs
+    * to, instead of scanning every piece again.
+    *
+    * @param[in]  slot   The stored slot
+    * @param[in]  color  The color
+    */
+   void SetTrackedSticker(int slot, eCubeColor color);
+
+   /**
+    * @brief      Looks up where the reference sticker of the piece with the given colors is stored.
+    *
+    * @param[in]  colorMask  One bit per color of the piece
+    *
+    * @return     The stored slot, or -1 if the piece isn't on the cube.
+    */
+   int GetPieceSlot(uint32_t colorMask) const;
+
+   // For every orientation, where each sticker seen through it is stored.
+   static const std::array<std::array<uint8_t, EnumToInt(eCubeFace::NumFaces) * CubeSize * CubeSize>,
+      NumOrientations> sOrientationSlots;
+
+   // Aligned so every face can be loaded straight into an SSE register.
+   alignas(16) CubeFaceData mCube;
+   // Where the reference sticker of each piece is stored, only kept up to date when tracking.
+   std::array<uint8_t, NumTrackedPieces> mPieceSlots;
+   uint8_t mOrientation = 0;
+   bool mVirtualRotations = false;
+   bool mTrackPieces = false;
+};
+}   // namespace cube
+
+template <>
+struct std::hash<cube::Cube>
+{
+   size_t operator()(const cube::Cube& cube) const
+   {
+      return static_cast<size_t>(cube.Hash());
+   }
 };
-}   // namespace cube
\ No newline at end of file
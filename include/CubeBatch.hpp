@@ -0,0 +1,148 @@
+#pragma once
+
+#include "Cube.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace cube
+{
+/**
+ * @brief      Stores many cubes in structure of arrays layout so the same move can be applied to
+ * all of them at once.
+ *
+ * Storage is sticker major: every sticker position (face * 9 + index) owns a row holding that
+ * sticker for every cube in the batch. A move copies whole rows, and predicates compare whole rows,
+ * so every loop runs over contiguous bytes of many cubes.
+ */
+class CubeBatch
+{
+public:
+   static constexpr int NumStickers = EnumToInt(eCubeFace::NumFaces) * CubeSize * CubeSize;
+
+   /**
+    * @brief      Creates a batch of solved cubes.
+    *
+    * @param[in]  numCubes  The number of cubes
+    */
+   explicit CubeBatch(size_t numCubes);
+
+   /**
+    * @return     The number of cubes in the batch.
+    */
+   inline size_t GetNumCubes() const
+   {
+      return mNumCubes;
+   }
+
+   /**
+    * @brief      Sets every cube to the default solved state.
+    */
+   void SetSolved();
+
+   /**
+    * @brief      Scatters the state of a cube into the batch.
+    *
+    * @param[in]  index  The index in the batch
+    * @param[in]  cube   The cube
+    */
+   void SetCube(size_t index, const Cube& cube);
+
+   /**
+    * @brief      Gathers the state of one cube of the batch.
+    *
+    * @param[in]  index  The index in the batch
+    * @param      cube   The cube
+    */
+   void GetCube(size_t index, Cube& cube) const;
+
+   /**
+    * @brief      Executes a single move on every cube.
+    *
+    * @param[in]  move  The move
+    */
+   void ExecuteMove(eCubeMove move);
+
+   /**
+    * @brief      Executes a series of moves on every cube.
+    *
+    * @param      moves     The moves
+    * @param[in]  numMoves  The number moves
+    */
+   void ExecuteMoves(const eCubeMove* moves, size_t numMoves);
+
+   /**
+    * @brief      Checks which cubes are solved.
+    *
+    * @param      results  One entry per cube, 1 if solved and 0 otherwise
+    */
+   void IsSolved(std::vector<uint8_t>& results) const;
+
+   /**
+    * @brief      Checks which cubes have every sticker of a face matching its center.
+    *
+    * @param[in]  face     The face
+    * @param      results  One entry per cube, 1 if the face is solved and 0 otherwise
+    */
+   void IsFaceSolved(eCubeFace face, std::vector<uint8_t>& results) const;
+
+   /**
+    * @brief      Checks which cubes have every sticker of a face set to the given color.
+    *
+    * @param[in]  face     The face
+    * @param[in]  color    The color
+    * @param      results  One entry per cube, 1 if it matches and 0 otherwise
+    */
+   void IsFaceColor(eCubeFace face, eCubeColor color, std::vector<uint8_t>& results) const;
+
+   /**
+    * @brief      Checks which cubes are solvable. Color counts are checked for the whole batch
+    * first, only the cubes passing that are converted to pieces and fully validated.
+    *
+    * @param      results  One entry per cube, see Cube::CheckValidity
+    */
+   void CheckValidity(std::vector<eCubeValidity>& results) const;
+
+   /**
+    * @return     The color of one sticker of one cube. See Cube::GetState for the indexing scheme.
+    */
+   inline eCubeColor GetState(size_t index, eCubeFace face, int x, int y) const
+   {
+      return GetRow(StickerOf(face, x, y))[index];
+   }
+
+   /**
+    * @return     The given sticker of every cube, one byte per cube.
+    */
+   inline const eCubeColor* GetStickerRow(eCubeFace face, int x, int y) const
+   {
+      return GetRow(StickerOf(face, x, y));
+   }
+
+private:
+   [[nodiscard]] static constexpr int StickerOf(eCubeFace face, int x, int y)
+   {
+      return EnumToInt(face) * CubeSize * CubeSize + CubeDimsToIdx(x, y);
+   }
+
+   inline eCubeColor* GetRow(int sticker)
+   {
+      return mStickers.data() + sticker * mRowStride;
+   }
+
+   inline const eCubeColor* GetRow(int sticker) const
+   {
+      return mStickers.data() + sticker * mRowStride;
+   }
+
+   /**
+    * @brief      ANDs results with whether every sticker of the face equals the reference row.
+    */
+   void AndFaceMatches(eCubeFace face, const eCubeColor* reference, std::vector<uint8_t>& results) const;
+
+   size_t mNumCubes;
+   size_t mRowStride;
+   std::vector<eCubeColor> mStickers;
+   std::vector<eCubeColor> mScratch;
+};
+}   // namespace cube
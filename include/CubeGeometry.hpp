@@ -0,0 +1,144 @@
+#pragma once
+
+#include "Cube.hpp"
+
+#include <array>
+
+namespace cube
+{
+constexpr int NumCubeStickers = EnumToInt(eCubeFace::NumFaces) * CubeSize * CubeSize;
+
+/**
+ * @brief      A position or direction in space. X points to the right face, Y to the top and Z to
+ * the front, the center of the cube is the origin.
+ */
+struct tVec3
+{
+   int X;
+   int Y;
+   int Z;
+
+   constexpr bool operator==(const tVec3& other) const = default;
+
+   [[nodiscard]] constexpr tVec3 operator+(const tVec3& other) const
+   {
+      return { X + other.X, Y + other.Y, Z + other.Z };
+   }
+
+   [[nodiscard]] constexpr tVec3 operator*(int scale) const
+   {
+      return { X * scale, Y * scale, Z * scale };
+   }
+
+   [[nodiscard]] constexpr int Dot(const tVec3& other) const
+   {
+      return X * other.X + Y * other.Y + Z * other.Z;
+   }
+
+   [[nodiscard]] constexpr int Along(eCubeAxis axis) const
+   {
+      return axis == eCubeAxis::XAxis ? X : (axis == eCubeAxis::YAxis ? Y : Z);
+   }
+
+   /**
+    * @brief      Rotates by 90 degrees counter clockwise around the axis (right hand rule).
+    */
+   [[nodiscard]] constexpr tVec3 RotateQuarter(eCubeAxis axis) const
+   {
+      switch (axis)
+      {
+      case eCubeAxis::XAxis:
+         return { X, -Z, Y };
+      case eCubeAxis::YAxis:
+         return { Z, Y, -X };
+      default:
+         return { -Y, X, Z };
+      }
+   }
+};
+
+/**
+ * @brief      Where a sticker is in space: the position of its piece, with every coordinate in
+ * [-1, 1], and the direction it faces.
+ */
+struct tStickerGeometry
+{
+   tVec3 Position;
+   tVec3 Normal;
+
+   constexpr bool operator==(const tStickerGeometry& other) const = default;
+};
+
+/**
+ * @brief      Places the sticker at the given face coordinates in space. Follows the indexing
+ * scheme described in Cube::GetState.
+ */
+[[nodiscard]] constexpr tStickerGeometry GetStickerGeometry(eCubeFace face, int x, int y)
+{
+   switch (face)
+   {
+   case eCubeFace::Top:
+      return { { x - 1, 1, y - 1 }, { 0, 1, 0 } };
+   case eCubeFace::Bottom:
+      return { { x - 1, -1, 1 - y }, { 0, -1, 0 } };
+   case eCubeFace::Left:
+      return { { -1, 1 - y, x - 1 }, { -1, 0, 0 } };
+   case eCubeFace::Right:
+      return { { 1, 1 - y, 1 - x }, { 1, 0, 0 } };
+   case eCubeFace::Front:
+      return { { x - 1, 1 - y, 1 }, { 0, 0, 1 } };
+   default:
+      return { { 1 - x, 1 - y, -1 }, { 0, 0, -1 } };
+   }
+}
+
+[[nodiscard]] constexpr tStickerGeometry GetStickerGeometry(int sticker)
+{
+   constexpr int faceStickers = CubeSize * CubeSize;
+   return GetStickerGeometry(static_cast<eCubeFace>(sticker / faceStickers),
+      sticker % faceStickers % CubeSize, sticker % faceStickers / CubeSize);
+}
+
+[[nodiscard]] constexpr int FindSticker(const tStickerGeometry& geometry)
+{
+   for (int sticker = 0; sticker < NumCubeStickers; sticker++)
+   {
+      if (GetStickerGeometry(sticker) == geometry)
+      {
+         return sticker;
+      }
+   }
+
+   return -1;
+}
+
+/**
+ * @return     The direction the given face points to.
+ */
+[[nodiscard]] constexpr tVec3 GetFaceNormal(eCubeFace face)
+{
+   return GetStickerGeometry(face, CubeSize / 2, CubeSize / 2).Normal;
+}
+
+/**
+ * @brief      Finds the stickers of the piece at the given position, in face order.
+ *
+ * @param[in]  position  The position of the piece, every coordinate in [-1, 1]
+ * @param      stickers  The stickers, as face * 9 + index
+ *
+ * @return     The number of stickers found, 1 for centers, 2 for edges and 3 for corners.
+ */
+[[nodiscard]] constexpr int GetPieceStickers(const tVec3& position, std::array<int, 3>& stickers)
+{
+   int count = 0;
+   for (int sticker = 0; sticker < NumCubeStickers && count < 3; sticker++)
+   {
+      if (GetStickerGeometry(sticker).Position == position)
+      {
+         stickers[count++] = sticker;
+      }
+   }
+
+   return count;
+}
+}   // namespace cube
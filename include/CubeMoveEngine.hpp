@@ -0,0 +1,129 @@
+#pragma once
+
+#include "Cube.hpp"
+
+#include <array>
+#include <cstdint>
+
+namespace cube
+{
+/**
+ * @brief      Byte shuffle masks producing one destination face. Each mask picks bytes out of one
+ * source face; a mask byte with the top bit set produces zero, so the results can be ORed together.
+ */
+struct alignas(16) tFaceShuffle
+{
+   static constexpr int MaxSources = 2;
+   static constexpr uint8_t ZeroByte = 0x80;
+
+   std::array<std::array<uint8_t, FaceStride>, MaxSources> Masks;
+   std::array<uint8_t, MaxSources> SrcFaces;
+};
+
+/**
+ * @brief      Everything needed to execute one move as byte shuffles. Every destination face is
+ * built from at most two source faces for every move in eCubeMove.
+ */
+struct tMoveShuffle
+{
+   std::array<tFaceShuffle, EnumToInt(eCubeFace::NumFaces)> Faces;
+};
+
+/**
+ * @brief      Byte shuffle masks for an arbitrary sticker permutation, where a destination face can
+ * be built from any of the source faces. Masks[dst][src] picks the bytes of face dst coming from
+ * face src.
+ */
+struct alignas(16) tPermutationShuffle
+{
+   static constexpr int NumFaces = EnumToInt(eCubeFace::NumFaces);
+
+   std::array<std::array<std::array<uint8_t, FaceStride>, NumFaces>, NumFaces> Masks;
+};
+
+/**
+ * @brief      Sticker conditions checked with a single mask and compare per face. References[face]
+ * holds, for every sticker of the face, the index of a byte in a lookup table: bytes 0 to 5 are
+ * the colors of the 6 centers and byte FixedColors + color is the color itself. CheckMasks is 0xFF
+ * for the stickers that are checked and 0 for the rest.
+ */
+struct alignas(16) tStickerPattern
+{
+   static constexpr int NumFaces = EnumToInt(eCubeFace::NumFaces);
+   static constexpr uint8_t FixedColors = 8;
+
+   std::array<std::array<uint8_t, FaceStride>, NumFaces> References;
+   std::array<std::array<uint8_t, FaceStride>, NumFaces> CheckMasks;
+};
+
+/**
+ * @brief      Builds the shuffle of a move from a cube where every sticker was set to its own
+ * position (face * FaceStride + index) before executing the move.
+ *
+ * @param[in]  labeledResult  The labeled cube after the move
+ *
+ * @return     The move shuffle.
+ */
+tMoveShuffle BuildMoveShuffle(const CubeFaceData& labeledResult);
+
+/**
+ * @brief      Builds the shuffle of an arbitrary permutation from a labeled cube, see
+ * BuildMoveShuffle.
+ *
+ * @param[in]  labeledResult  The labeled cube after the permutation
+ *
+ * @return     The permutation shuffle.
+ */
+tPermutationShuffle BuildPermutationShuffle(const CubeFaceData& labeledResult);
+
+/**
+ * @return     True if the CPU supports the instructions needed by ExecuteMoveShuffle.
+ */
+bool IsShuffleEngineSupported();
+
+/**
+ * @brief      Executes a move shuffle on the given sticker data. Only call this if
+ * IsShuffleEngineSupported returns true. Padding bytes are cleared.
+ *
+ * @param      faceData  The face data, must be 16 byte aligned
+ * @param[in]  shuffle   The shuffle
+ */
+void ExecuteMoveShuffle(CubeFaceData& faceData, const tMoveShuffle& shuffle);
+
+/**
+ * @brief      Executes several move shuffles in order, see ExecuteMoveShuffle. The faces stay in
+ * a local array from the first shuffle to the last and are only stored back at the end.
+ *
+ * @param      faceData     The face data, must be 16 byte aligned
+ * @param[in]  shuffles     The shuffles
+ * @param[in]  numShuffles  The number of shuffles
+ */
+void ExecuteMoveShuffles(
+   CubeFaceData& faceData, const tMoveShuffle* const* shuffles, size_t numShuffles);
+
+/**
+ * @brief      Executes a permutation shuffle on the given sticker data. Same requirements as
+ * ExecuteMoveShuffle.
+ *
+ * @param      faceData  The face data, must be 16 byte aligned
+ * @param[in]  shuffle   The shuffle
+ */
+void ExecutePermutationShuffle(CubeFaceData& faceData, const tPermutationShuffle& shuffle);
+
+/**
+ * @brief      Returns true if every checked sticker matches its reference.
+ *
+ * @param[in]  faceData  The face data
+ * @param[in]  pattern   The pattern
+ */
+bool MatchStickerPattern(const CubeFaceData& faceData, const tStickerPattern& pattern);
+
+/**
+ * @brief      Same as MatchStickerPattern, with byte shuffles. Same requirements as
+ * ExecuteMoveShuffle.
+ *
+ * @param[in]  faceData  The face data, must be 16 byte aligned
+ * @param[in]  pattern   The pattern
+ */
+bool MatchStickerPatternShuffle(const CubeFaceData& faceData, const tStickerPattern& pattern);
+}   // namespace cube
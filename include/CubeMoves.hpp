@@ -0,0 +1,198 @@
+#pragma once
+
+#include "Cube.hpp"
+
+#include <array>
+#include <cstdint>
+
+namespace cube
+{
+constexpr int NumMoves = EnumToInt(eCubeMove::NumMoves);
+
+// Layers of a move along its axis. Bit 0 is the layer at -1 along the axis, bit 1 the middle layer
+// and bit 2 the layer at +1.
+constexpr uint8_t NegativeLayer = 0b001;
+constexpr uint8_t MiddleLayer = 0b010;
+constexpr uint8_t PositiveLayer = 0b100;
+constexpr uint8_t AllLayers = NegativeLayer | MiddleLayer | PositiveLayer;
+
+/**
+ * @brief      Everything about one eCubeMove, see GetMoveInfo.
+ */
+struct tMoveInfo
+{
+   // The face turned. Slices give the face they follow (M follows L, E follows D, S follows F) and
+   // rotations the face they turn like (x like R, y like U, z like F).
+   eCubeFace Face;
+   eCubeAxis Axis;
+   uint8_t LayerMask;
+   // Counter clockwise when looking at the axis from its positive end (right hand rule), so R is 3
+   // quarter turns around X while L is 1.
+   uint8_t QuarterTurns;
+   eCubeMove Inverse;
+   bool IsRotation;
+   // One bit per move this move commutes with: moves around the same axis, and half turns of layers
+   // centered on the cube (M2, E2, S2, x2, y2, z2) with each other.
+   uint64_t CommutingMoves;
+};
+
+/**
+ * @brief      A clockwise move and the face it belongs to, one per group of 3 moves in eCubeMove.
+ */
+struct tMoveFamily
+{
+   eCubeFace Face;
+   eCubeAxis Axis;
+   uint8_t LayerMask;
+   uint8_t QuarterTurns;
+};
+
+/**
+ * @brief      The clockwise version of every move family, in eCubeMove order. The prime and double
+ * versions follow each one in the enum.
+ */
+constexpr std::array<tMoveFamily, NumMoves / 3> MoveFamilies = { {
+   { eCubeFace::Top, eCubeAxis::YAxis, PositiveLayer, 3 },                    // U
+   { eCubeFace::Bottom, eCubeAxis::YAxis, NegativeLayer, 1 },                 // D
+   { eCubeFace::Right, eCubeAxis::XAxis, PositiveLayer, 3 },                  // R
+   { eCubeFace::Left, eCubeAxis::XAxis, NegativeLayer, 1 },                   // L
+   { eCubeFace::Front, eCubeAxis::ZAxis, PositiveLayer, 3 },                  // F
+   { eCubeFace::Back, eCubeAxis::ZAxis, NegativeLayer, 1 },                   // B
+   { eCubeFace::Top, eCubeAxis::YAxis, PositiveLayer | MiddleLayer, 3 },      // Uw
+   { eCubeFace::Bottom, eCubeAxis::YAxis, NegativeLayer | MiddleLayer, 1 },   // Dw
+   { eCubeFace::Right, eCubeAxis::XAxis, PositiveLayer | MiddleLayer, 3 },    // Rw
+   { eCubeFace::Left, eCubeAxis::XAxis, NegativeLayer | MiddleLayer, 1 },     // Lw
+   { eCubeFace::Front, eCubeAxis::ZAxis, PositiveLayer | MiddleLayer, 3 },    // Fw
+   { eCubeFace::Back, eCubeAxis::ZAxis, NegativeLayer | MiddleLayer, 1 },     // Bw
+   { eCubeFace::Left, eCubeAxis::XAxis, MiddleLayer, 1 },                     // M
+   { eCubeFace::Bottom, eCubeAxis::YAxis, MiddleLayer, 1 },                   // E
+   { eCubeFace::Front, eCubeAxis::ZAxis, MiddleLayer, 3 },                    // S
+   { eCubeFace::Right, eCubeAxis::XAxis, AllLayers, 3 },                      // x
+   { eCubeFace::Top, eCubeAxis::YAxis, AllLayers, 3 },                        // y
+   { eCubeFace::Front, eCubeAxis::ZAxis, AllLayers, 3 },                      // z
+} };
+
+/**
+ * @brief      The metadata of every move, in eCubeMove order.
+ */
+constexpr std::array<tMoveInfo, NumMoves> MoveInfos = []()
+{
+   std::array<tMoveInfo, NumMoves> result = {};
+   for (int move = 0; move < NumMoves; move++)
+   {
+      const tMoveFamily& family = MoveFamilies[move / 3];
+      int familyStart = move - move % 3;
+
+      tMoveInfo& info = result[move];
+      info.Face = family.Face;
+      info.Axis = family.Axis;
+      info.LayerMask = family.LayerMask;
+      info.IsRotation = family.LayerMask == AllLayers;
+
+      // Moves come as clockwise, prime, double.
+      switch (move % 3)
+      {
+      case 0:
+         info.QuarterTurns = family.QuarterTurns;
+         info.Inverse = static_cast<eCubeMove>(familyStart + 1);
+         break;
+      case 1:
+         info.QuarterTurns = static_cast<uint8_t>((4 - family.QuarterTurns) % 4);
+         info.Inverse = static_cast<eCubeMove>(familyStart);
+         break;
+      default:
+         info.QuarterTurns = 2;
+         info.Inverse = static_cast<eCubeMove>(move);
+         break;
+      }
+
+      // Turns around the same axis never share a sticker. Around different axes, a half turn maps
+      // the layers of the other axis onto their mirror, which only leaves centered layers alone.
+      bool isCenteredHalfTurn = move % 3 == 2 &&
+                                (family.LayerMask == MiddleLayer || family.LayerMask == AllLayers);
+      for (int other = 0; other < NumMoves; other++)
+      {
+         const tMoveFamily& otherFamily = MoveFamilies[other / 3];
+         bool isOtherCenteredHalfTurn =
+            other % 3 == 2 &&
+            (otherFamily.LayerMask == MiddleLayer || otherFamily.LayerMask == AllLayers);
+         if (otherFamily.Axis == family.Axis || (isCenteredHalfTurn && isOtherCenteredHalfTurn))
+         {
+            info.CommutingMoves |= uint64_t(1) << other;
+         }
+      }
+   }
+
+   return result;
+}();
+
+static_assert(NumMoves <= 64, "CommutingMoves needs a bit per move.");
+
+/**
+ * @return     The metadata of the given move.
+ */
+[[nodiscard]] constexpr const tMoveInfo& GetMoveInfo(eCubeMove move)
+{
+   return MoveInfos[EnumToInt(move)];
+}
+
+/**
+ * @return     The move undoing the given move.
+ */
+[[nodiscard]] constexpr eCubeMove GetInverseMove(eCubeMove move)
+{
+   return MoveInfos[EnumToInt(move)].Inverse;
+}
+
+/**
+ * @return     True if executing the moves in either order gives the same result.
+ */
+[[nodiscard]] constexpr bool DoMovesCommute(eCubeMove first, eCubeMove second)
+{
+   return (MoveInfos[EnumToInt(first)].CommutingMoves >> EnumToInt(second)) & 1;
+}
+
+/**
+ * @brief      Combines two moves turning the same layers, like R R into R2 or U2 U into U'.
+ *
+ * @param[in]  first   The first move
+ * @param[in]  second  The second move
+ * @param      merged  The move doing both, or eCubeMove::NumMoves if they cancel out
+ *
+ * @return     False if the moves turn different layers and can't be combined.
+ */
+constexpr bool MergeMoves(eCubeMove first, eCubeMove second, eCubeMove& merged)
+{
+   int family = EnumToInt(first) / 3;
+   if (family != EnumToInt(second) / 3)
+   {
+      return false;
+   }
+
+   int quarterTurns = (GetMoveInfo(first).QuarterTurns + GetMoveInfo(second).QuarterTurns) % 4;
+   merged = eCubeMove::NumMoves;
+   for (int move = family * 3; move < family * 3 + 3; move++)
+   {
+      if (MoveInfos[move].QuarterTurns == quarterTurns)
+      {
+         merged = static_cast<eCubeMove>(move);
+      }
+   }
+
+   return true;
+}
+
+/**
+ * @return     The axis going through the given face.
+ */
+[[nodiscard]] constexpr eCubeAxis GetAxisOfFace(eCubeFace face)
+{
+   // Top and Bottom come first, then Left and Right, then Front and Back.
+   constexpr std::array<eCubeAxis, EnumToInt(eCubeFace::NumFaces)> faceAxes = {
+      eCubeAxis::YAxis, eCubeAxis::YAxis, eCubeAxis::XAxis,
+      eCubeAxis::XAxis, eCubeAxis::ZAxis, eCubeAxis::ZAxis,
+   };
+
+   return faceAxes[EnumToInt(face)];
+}
+}   // namespace cube
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "Cube.hpp"
+#include "CubeBatch.hpp"
+#include "CubeMoveEngine.hpp"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace cube
+{
+/**
+ * @brief      A set of sticker conditions evaluated together as one mask and compare per face.
+ * Every checked sticker has to match either the center of some face or a fixed color; the rest are
+ * ignored.
+ *
+ * Conditions are stated on the stickers as they are seen. The pattern is precomputed for every
+ * orientation, so cubes viewed through an orientation are checked without flattening them.
+ */
+class StickerPredicate
+{
+public:
+   /**
+    * @brief      Creates a predicate without conditions, every cube matches it.
+    */
+   StickerPredicate();
+
+   /**
+    * @brief      Requires a sticker to have the color of the center of a face.
+    *
+    * @param[in]  face        The face of the sticker
+    * @param[in]  x           The x coordinate of the sticker
+    * @param[in]  y           The y coordinate of the sticker
+    * @param[in]  centerFace  The face whose center color is expected
+    *
+    * @return     This predicate.
+    */
+   StickerPredicate& RequireCenterColor(eCubeFace face, int x, int y, eCubeFace centerFace);
+
+   /**
+    * @brief      Requires a sticker to have the given color.
+    *
+    * @param[in]  face   The face of the sticker
+    * @param[in]  x      The x coordinate of the sticker
+    * @param[in]  y      The y coordinate of the sticker
+    * @param[in]  color  The color
+    *
+    * @return     This predicate.
+    */
+   StickerPredicate& RequireColor(eCubeFace face, int x, int y, eCubeColor color);
+
+   /**
+    * @brief      Requires every sticker of a face to have the color of its center.
+    *
+    * @param[in]  face  The face
+    *
+    * @return     This predicate.
+    */
+   StickerPredicate& RequireFace(eCubeFace face);
+
+   /**
+    * @brief      Requires the piece between the given faces to be solved: each of its stickers has
+    * the color of the center of the face it is on.
+    *
+    * @param[in]  face1  The first face
+    * @param[in]  face2  The second face
+    * @param[in]  face3  The third face for corners, NumFaces for edges
+    *
+    * @return     This predicate.
+    */
+   StickerPredicate& RequirePiece(
+      eCubeFace face1, eCubeFace face2, eCubeFace face3 = eCubeFace::NumFaces);
+
+   /**
+    * @brief      Returns true if the cube satisfies every condition.
+    *
+    * @param[in]  cube  The cube
+    */
+   bool Matches(const Cube& cube) const;
+
+   /**
+    * @brief      Checks which cubes of a batch satisfy every condition.
+    *
+    * @param[in]  batch    The batch
+    * @param      results  One entry per cube, 1 if it matches and 0 otherwise
+    */
+   void Matches(const CubeBatch& batch, std::vector<uint8_t>& results) const;
+
+   /**
+    * @return     Every face has the color of its center.
+    */
+   static const StickerPredicate& Solved();
+
+   /**
+    * @return     Every sticker of the face has the color of its center.
+    */
+   static const StickerPredicate& FaceSolved(eCubeFace face);
+
+   /**
+    * @return     The edge between a side face and the bottom face is solved.
+    */
+   static const StickerPredicate& CrossEdge(eCubeFace sideFace);
+
+   /**
+    * @return     Every edge of the bottom face is solved.
+    */
+   static const StickerPredicate& Cross();
+
+   /**
+    * @return     The bottom corner and middle layer edge between two adjacent side faces are
+    * solved.
+    */
+   static const StickerPredicate& F2lPair(eCubeFace sideFace1, eCubeFace sideFace2);
+
+   /**
+    * @return     The bottom two layers are solved.
+    */
+   static const StickerPredicate& FirstTwoLayers();
+
+   /**
+    * @return     The bottom two layers are solved and the top face has a single color.
+    */
+   static const StickerPredicate& OrientedLastLayer();
+
+private:
+   /**
+    * @brief      Sets the reference of a seen sticker in the pattern of every orientation.
+    *
+    * @param[in]  face       The face of the sticker
+    * @param[in]  x          The x coordinate of the sticker
+    * @param[in]  y          The y coordinate of the sticker
+    * @param[in]  reference  The reference, a seen face for center colors or
+    *                        tStickerPattern::FixedColors + color
+    */
+   void SetReference(eCubeFace face, int x, int y, int reference);
+
+   std::array<tStickerPattern, NumOrientations> mPatterns;
+};
+}   // namespace cube
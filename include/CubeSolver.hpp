@@ -1,7 +1,12 @@
 #pragma once
 
+#include "CompiledAlgorithm.hpp"
 #include "Cube.hpp"
+#include "CubeMoves.hpp"
+#include "MoveBuffer.hpp"
+#include <array>
 #include <ostream>
+#include <span>
 
 namespace cube
 {
@@ -21,13 +26,6 @@ enum class eFaceCornerPos
    BottomRight
 };
 
-enum class eCubeAxis
-{
-   YAxis,
-   XAxis,
-   ZAxis
-};
-
 constexpr int GetNumEdgeTypes() 
 {
    return static_cast<int>(eFaceEdgePos::BottomEdge) + 1;
@@ -76,11 +74,28 @@ public:
     */
    void PushMoves(const std::vector<eCubeMove>& moves, bool acceptMoves = false)
    {
-      for (const auto& move : moves)
+      SaveRollbackPoint(acceptMoves);
+      mPendingMoves.Append(moves);
+      mCube.ExecuteMoves(std::span<const eCubeMove>(moves));
+
+      if (acceptMoves)
       {
-         mPendingMoves.push_back(move);
-         mCube.ExecuteMove(move);
+         AcceptPendingMoves();
       }
+   }
+
+   /**
+    * @brief      Simulates a compiled algorithm in one step, but doesn't append its moves to the
+    * move list yet.
+    *
+    * @param[in]  algorithm    The algorithm
+    * @param[in]  acceptMoves  The accept moves
+    */
+   void PushMoves(const CompiledAlgorithm& algorithm, bool acceptMoves = false)
+   {
+      SaveRollbackPoint(acceptMoves);
+      mPendingMoves.Append(algorithm.GetMoves());
+      mCube.ExecuteAlgorithm(algorithm);
 
       if (acceptMoves)
       {
@@ -96,7 +111,8 @@ public:
     */
    void PushMove(eCubeMove move, bool acceptMoves = false)
    {
-      mPendingMoves.push_back(move);
+      SaveRollbackPoint(acceptMoves);
+      mPendingMoves.Push(move);
       mCube.ExecuteMove(move);
 
       if (acceptMoves)
@@ -106,23 +122,81 @@ public:
    }
 
    /**
-    * @brief      Pushes all pending moves to the moves list.
+    * @brief      Pushes all pending moves to the moves list. The list is kept canonical as moves
+    * come in, see AppendMove, so it can be shorter than the moves executed on the cube.
     */
    void AcceptPendingMoves()
    {
-      mMoves.insert(mMoves.end(), mPendingMoves.begin(), mPendingMoves.end());
-      mPendingMoves.clear();
+      assert(mNumSavepoints == 0 && "Release the savepoints before accepting their moves.");
+      for (eCubeMove move : mPendingMoves.GetMoves())
+      {
+         AppendMove(move);
+      }
+
+      mPendingMoves.Clear();
    }
 
    /**
-    * @brief      Reverses the pending moves on the cube and doesn't add them to the move list. 
+    * @brief      Puts the cube back to where it was before the pending moves and doesn't add them to
+    * the move list.
     */
    void RejectPendingMoves()
    {
-      std::vector<eCubeMove> reverseMoves;
-      Cube::ReverseMoves(mPendingMoves, reverseMoves);
-      mCube.ExecuteMoves(reverseMoves.data(), reverseMoves.size());
-      mPendingMoves.clear();
+      if (!mPendingMoves.IsEmpty())
+      {
+         mCube.RestoreSnapshot(mRollbackPoint);
+         mPendingMoves.Clear();
+      }
+
+      mNumSavepoints = 0;
+   }
+
+   /**
+    * @brief      Marks the current state so the pending moves pushed after it can be undone without
+    * touching the ones pushed before. Savepoints nest, a solver can try a branch from one,
+    * create more inside it and return to any of them.
+    *
+    * @return     The savepoint, see RollbackToSavepoint and ReleaseSavepoint.
+    */
+   size_t CreateSavepoint()
+   {
+      assert(mNumSavepoints < MaxSavepoints && "Too many nested savepoints.");
+      tSavepoint& savepoint = mSavepoints[mNumSavepoints];
+      mCube.SaveSnapshot(savepoint.Cube);
+      savepoint.NumPendingMoves = mPendingMoves.GetSize();
+      return mNumSavepoints++;
+   }
+
+   /**
+    * @brief      Puts the cube back to where it was when the savepoint was created and drops the
+    * pending moves pushed since. Savepoints created after it are released, the savepoint itself
+    * stays so more branches can be tried from it.
+    *
+    * @param[in]  savepoint  The savepoint
+    */
+   void RollbackToSavepoint(size_t savepoint)
+   {
+      assert(savepoint < mNumSavepoints && "The savepoint was released.");
+      mCube.RestoreSnapshot(mSavepoints[savepoint].Cube);
+      mPendingMoves.Truncate(mSavepoints[savepoint].NumPendingMoves);
+      mNumSavepoints = savepoint + 1;
+   }
+
+   /**
+    * @brief      Releases the savepoint and every savepoint created after it. The moves pushed
+    * since stay pending, to be accepted or rejected with the rest.
+    *
+    * @param[in]  savepoint  The savepoint
+    */
+   void ReleaseSavepoint(size_t savepoint)
+   {
+      assert(savepoint < mNumSavepoints && "The savepoint was released.");
+      mNumSavepoints = savepoint;
+   }
+
+   size_t GetNumSavepoints() const
+   {
+      return mNumSavepoints;
    }
 
    /**
@@ -133,38 +207,120 @@ public:
     * 
     * @return     The moves.
     */
-   const std::vector<eCubeMove>& GetMoves()
+   std::span<const eCubeMove> GetMoves()
    {
       // Assert false to catch issues where we didn't accept or reject moves leaving the cube
       // in an incorrect state.
-      assert(mPendingMoves.size() == 0 && "There are pending moves.");
-      return mMoves;
+      assert(mPendingMoves.IsEmpty() && "There are pending moves.");
+      return mMoves.GetMoves();
    }
 
    /**
     * @brief      Prints the list of moves to the output stream.
-    * @param      outputStream  The stream to write data to
+    * @param      outputStream       The stream to write data to
+    * @param[in]  includeSeparators  True to write "- " between groups of 5 moves
     */
-   void SerializeMoves(std::ostream& outputStream)
+   void SerializeMoves(std::ostream& outputStream, bool includeSeparators = false)
    {
-      assert(mPendingMoves.size() == 0 && "There shuold be no pending moves.");
-      mCube.SerializeMoveList(outputStream, mMoves.data(), mMoves.size());
+      assert(mPendingMoves.IsEmpty() && "There shuold be no pending moves.");
+      mCube.SerializeMoveList(outputStream, mMoves.GetData(), mMoves.GetSize(), includeSeparators);
    }
 
    int GetNumMoves()
    {
-      return mMoves.size();
+      return mMoves.GetSize();
    }
 
    int GetNumPendingMoves()
    {
-      return mPendingMoves.size();
+      return mPendingMoves.GetSize();
    }
 
 private:
+   /**
+    * @brief      Saves the cube before the first pending move so rejecting is a single restore.
+    */
+   void SaveRollbackPoint(bool acceptMoves)
+   {
+      if (!acceptMoves && mPendingMoves.IsEmpty())
+      {
+         mCube.SaveSnapshot(mRollbackPoint);
+      }
+   }
+
+   /**
+    * @brief      Appends a move to the accepted moves, cancelling or merging it with an earlier
+    * move turning the same layers. The move is carried back past every move it commutes with (U
+    * past D, M2 past E2), so U D U' becomes D and R L2 R becomes R2 L2.
+    *
+    * @param[in]  move  The move
+    */
+   void AppendMove(eCubeMove move)
+   {
+      while (true)
+      {
+         // Find the closest earlier move turning the same layers that the move can reach.
+         size_t index = mMoves.GetSize();
+         eCubeMove merged = eCubeMove::NumMoves;
+         bool canMerge = false;
+         while (index > 0 && !canMerge)
+         {
+            index--;
+            canMerge = MergeMoves(mMoves[index], move, merged);
+            if (!canMerge && !DoMovesCommute(mMoves[index], move))
+            {
+               break;
+            }
+         }
+
+         if (!canMerge)
+         {
+            mMoves.Push(move);
+            return;
+         }
+
+         if (merged == eCubeMove::NumMoves)
+         {
+            mMoves.Erase(index);
+            return;
+         }
+
+         // The merged move keeps travelling back only if it still commutes with everything the
+         // move was carried past: M2 commutes with E2 but M doesn't.
+         for (size_t i = index + 1; i < mMoves.GetSize(); i++)
+         {
+            if (!DoMovesCommute(mMoves[i], merged))
+            {
+               mMoves.Set(index, merged);
+               return;
+            }
+         }
+
+         mMoves.Erase(index);
+         move = merged;
+      }
+   }
+
+   /**
+    * @brief      The cube and the number of pending moves when a savepoint was created.
+    */
+   struct tSavepoint
+   {
+      tCubeSnapshot Cube;
+      size_t NumPendingMoves;
+   };
+
+   // Enough for every stage of a CFOP solve, longer lists still work but allocate.
+   static constexpr size_t InlineMoves = 128;
+   static constexpr size_t InlinePendingMoves = 64;
+   static constexpr size_t MaxSavepoints = 8;
+
    Cube& mCube;
-   std::vector<eCubeMove> mMoves;
-   std::vector<eCubeMove> mPendingMoves;
+   MoveBuffer<InlineMoves> mMoves;
+   MoveBuffer<InlinePendingMoves> mPendingMoves;
+   tCubeSnapshot mRollbackPoint;
+   std::array<tSavepoint, MaxSavepoints> mSavepoints;
+   size_t mNumSavepoints = 0;
 };
 
 class CubeSolveUtils
@@ -279,26 +435,7 @@ public:
     */
    static eCubeAxis GetAxisForFace(eCubeFace face)
    {
-      switch (face)
-      {
-      case cube::eCubeFace::Front:
-      case cube::eCubeFace::Back:
-         return eCubeAxis::ZAxis;
-         break;
-      case cube::eCubeFace::Left:
-      case cube::eCubeFace::Right:
-         return eCubeAxis::XAxis;
-         break;
-      case cube::eCubeFace::Top:
-      case cube::eCubeFace::Bottom:
-         return eCubeAxis::YAxis;
-         break;
-      default:
-         assert(false);
-      }
-
-      // Invalid, default
-      return eCubeAxis::ZAxis;
+      return GetAxisOfFace(face);
    }
 
    /**
@@ -317,6 +454,14 @@ public:
    static bool IsCornerInPosition(Cube& cube, tCornerDescriptor& cornerDescriptor, 
       eCubeColor color1, eCubeColor color2, eCubeColor color3)
    {
+      if (cube.GetPieceTracking())
+      {
+         int x = 0;
+         int y = 0;
+         GetCornerPosition(cornerDescriptor.CornerY, x, y);
+         return cube.IsPieceAt(color1, color2, color3, cornerDescriptor.FaceY, x, y);
+      }
+
       eCubeColor yColor, xColor, zColor;
       GetCornerColors(cube, cornerDescriptor, yColor, xColor, zColor);
 
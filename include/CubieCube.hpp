@@ -0,0 +1,211 @@
+#pragma once
+
+#include "Cube.hpp"
+
+#include <array>
+#include <cstdint>
+
+namespace cube
+{
+/**
+ * @brief      The corner slots of the cube, named after the faces they touch.
+ */
+enum class eCorner : uint8_t
+{
+   URF,
+   UFL,
+   ULB,
+   UBR,
+   DFR,
+   DLF,
+   DBL,
+   DRB,
+   NumCorners
+};
+
+/**
+ * @brief      The edge slots of the cube, named after the faces they touch.
+ */
+enum class eEdge : uint8_t
+{
+   UR,
+   UF,
+   UL,
+   UB,
+   DR,
+   DF,
+   DL,
+   DB,
+   FR,
+   FL,
+   BL,
+   BR,
+   NumEdges
+};
+
+constexpr int NumCorners = EnumToInt(eCorner::NumCorners);
+constexpr int NumEdges = EnumToInt(eEdge::NumEdges);
+constexpr int NumCenters = EnumToInt(eCubeFace::NumFaces);
+
+/**
+ * @brief      Cube model based on pieces instead of stickers. Each slot stores which piece is in it
+ * and how that piece is twisted or flipped.
+ *
+ * Pieces are identified by their colors using the default color scheme, so the model does not
+ * depend on where the centers are. Slot orientation follows the usual convention: a corner's twist
+ * is the index of its U/D colored sticker (0 when it faces U or D, clockwise after that), an edge
+ * is flipped when its reference sticker is off the U/D face (or off F/B for the middle layer).
+ * The centers are tracked as well so slice moves and cube rotations convert without loss.
+ */
+class CubieCube
+{
+public:
+   /**
+    * @brief      Standard constructor. The cube starts solved.
+    */
+   CubieCube();
+
+   /**
+    * @brief      Builds the cubie state of the given cube. The cube must hold a valid set of pieces,
+    * otherwise the result is the solved state.
+    *
+    * @param[in]  cube  The cube
+    */
+   explicit CubieCube(const Cube& cube);
+
+   /**
+    * @brief      Sets the cube to the default solved state.
+    */
+   void SetSolved();
+
+   /**
+    * @brief      Returns true if every piece and center is home and oriented.
+    *
+    * @return     True if solved, False otherwise.
+    */
+   bool IsSolved() const;
+
+   /**
+    * @brief      Executes a single move.
+    *
+    * @param[in]  move  The move
+    */
+   void ExecuteMove(eCubeMove move);
+
+   /**
+    * @brief      Executes a series of moves
+    *
+    * @param      move      The move
+    * @param[in]  numMoves  The number moves
+    */
+   void ExecuteMoves(const eCubeMove* moves, size_t numMoves);
+
+   /**
+    * @brief      Applies other on top of this state (this = this * other).
+    *
+    * @param[in]  other  The other
+    */
+   void Multiply(const CubieCube& other);
+
+   /**
+    * @brief      Computes the inverse state directly from the pieces, without the moves that led
+    * to it. Multiplying a state by its inverse gives the solved cube, and executing the inverse
+    * on a solved cube undoes the moves of the original.
+    *
+    * @return     The inverse state.
+    */
+   CubieCube Inverse() const;
+
+   /**
+    * @brief      Checks that the pieces form a solvable cube: every piece appears once, the centers
+    * are arranged like on a real cube, the twists and flips add up and the corner and edge
+    * permutations have the same parity once the centers are brought home.
+    *
+    * @return     Whether the cube is solvable, or the first reason found why it isn't.
+    */
+   eCubeValidity CheckValidity() const;
+
+   /**
+    * @brief      Converts facelets to cubies.
+    *
+    * @param[in]  faceData  The facelet data
+    * @param      result    The cubie state, left unchanged if the conversion fails
+    *
+    * @return     False if some slot holds a color combination that isn't a piece.
+    */
+   static bool FromFaceData(const CubeFaceData& faceData, CubieCube& result);
+
+   /**
+    * @brief      Converts cubies to facelets.
+    *
+    * @param      faceData  The facelet data
+    */
+   void ToFaceData(CubeFaceData& faceData) const;
+
+   /**
+    * @brief      Writes the facelet state into the given cube.
+    *
+    * @param      cube  The cube
+    */
+   void Unpack(Cube& cube) const;
+
+   /**
+    * @return     The cubie state of a single move applied to the solved cube.
+    */
+   static const CubieCube& GetMoveCube(eCubeMove move);
+
+   inline eCorner GetCorner(eCorner slot) const
+   {
+      return static_cast<eCorner>(mCornerPerm[EnumToInt(slot)]);
+   }
+
+   inline int GetCornerTwist(eCorner slot) const
+   {
+      return mCornerTwist[EnumToInt(slot)];
+   }
+
+   inline eEdge GetEdge(eEdge slot) const
+   {
+      return static_cast<eEdge>(mEdgePerm[EnumToInt(slot)]);
+   }
+
+   inline int GetEdgeFlip(eEdge slot) const
+   {
+      return mEdgeFlip[EnumToInt(slot)];
+   }
+
+   /**
+    * @return     The face whose center currently sits on the given face.
+    */
+   inline eCubeFace GetCenter(eCubeFace face) const
+   {
+      return static_cast<eCubeFace>(mCenters[EnumToInt(face)]);
+   }
+
+   inline void SetCorner(eCorner slot, eCorner piece, int twist)
+   {
+      mCornerPerm[EnumToInt(slot)] = static_cast<uint8_t>(piece);
+      mCornerTwist[EnumToInt(slot)] = static_cast<uint8_t>(twist);
+   }
+
+   inline void SetEdge(eEdge slot, eEdge piece, int flip)
+   {
+      mEdgePerm[EnumToInt(slot)] = static_cast<uint8_t>(piece);
+      mEdgeFlip[EnumToInt(slot)] = static_cast<uint8_t>(flip);
+   }
+
+   inline void SetCenter(eCubeFace face, eCubeFace center)
+   {
+      mCenters[EnumToInt(face)] = static_cast<uint8_t>(center);
+   }
+
+   bool operator==(const CubieCube& other) const = default;
+
+private:
+   std::array<uint8_t, NumCorners> mCornerPerm;
+   std::array<uint8_t, NumCorners> mCornerTwist;
+   std::array<uint8_t, NumEdges> mEdgePerm;
+   std::array<uint8_t, NumEdges> mEdgeFlip;
+   std::array<uint8_t, NumCenters> mCenters;
+};
+}   // namespace cube
@@ -0,0 +1,183 @@
+#pragma once
+
+#include "Cube.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <span>
+#include <vector>
+
+namespace cube
+{
+/**
+ * @brief      A list of moves stored inline up to a fixed capacity. Lists that outgrow it move to
+ * the heap once and stay there until cleared, so a buffer sized for the usual case never
+ * allocates.
+ */
+template <size_t TInlineCapacity>
+class MoveBuffer
+{
+public:
+   /**
+    * @brief      Appends a move.
+    *
+    * @param[in]  move  The move
+    */
+   void Push(eCubeMove move)
+   {
+      if (mSize < TInlineCapacity)
+      {
+         mInline[mSize++] = move;
+         return;
+      }
+
+      Spill();
+      mSpill.push_back(move);
+      mSize++;
+   }
+
+   /**
+    * @brief      Appends a series of moves.
+    *
+    * @param[in]  moves  The moves
+    */
+   void Append(std::span<const eCubeMove> moves)
+   {
+      if (mSize + moves.size() <= TInlineCapacity)
+      {
+         std::copy(moves.begin(), moves.end(), mInline.begin() + mSize);
+         mSize += moves.size();
+         return;
+      }
+
+      Spill();
+      mSpill.insert(mSpill.end(), moves.begin(), moves.end());
+      mSize += moves.size();
+   }
+
+   /**
+    * @brief      Replaces the move at the given index.
+    *
+    * @param[in]  index  The index
+    * @param[in]  move   The move
+    */
+   void Set(size_t index, eCubeMove move)
+   {
+      assert(index < mSize && "Index out of range.");
+      (IsSpilled() ? mSpill.data() : mInline.data())[index] = move;
+   }
+
+   /**
+    * @brief      Removes the move at the given index, the following moves shift down. A spilled
+    * buffer goes back to inline storage once its moves fit again.
+    *
+    * @param[in]  index  The index
+    */
+   void Erase(size_t index)
+   {
+      assert(index < mSize && "Index out of range.");
+      if (!IsSpilled())
+      {
+         std::copy(mInline.begin() + index + 1, mInline.begin() + mSize, mInline.begin() + index);
+         mSize--;
+         return;
+      }
+
+      mSpill.erase(mSpill.begin() + index);
+      mSize--;
+      Unspill();
+   }
+
+   /**
+    * @brief      Removes every move from the given index on.
+    *
+    * @param[in]  size  The number of moves to keep
+    */
+   void Truncate(size_t size)
+   {
+      assert(size <= mSize && "Can't grow a buffer by truncating it.");
+      if (IsSpilled())
+      {
+         mSpill.resize(size);
+      }
+
+      mSize = size;
+      Unspill();
+   }
+
+   /**
+    * @brief      Removes every move. Heap storage is kept but the buffer goes back to inline
+    * storage, it is only used again if the buffer outgrows its inline capacity again.
+    */
+   void Clear()
+   {
+      mSize = 0;
+      mSpill.clear();
+   }
+
+   inline size_t GetSize() const
+   {
+      return mSize;
+   }
+
+   inline bool IsEmpty() const
+   {
+      return mSize == 0;
+   }
+
+   /**
+    * @return     True if the moves are on the heap.
+    */
+   inline bool IsSpilled() const
+   {
+      return mSize > TInlineCapacity;
+   }
+
+   inline const eCubeMove* GetData() const
+   {
+      return IsSpilled() ? mSpill.data() : mInline.data();
+   }
+
+   inline std::span<const eCubeMove> GetMoves() const
+   {
+      return { GetData(), mSize };
+   }
+
+   inline eCubeMove operator[](size_t index) const
+   {
+      assert(index < mSize && "Index out of range.");
+      return GetData()[index];
+   }
+
+private:
+   /**
+    * @brief      Moves the inline moves to the heap the first time the inline capacity is
+    * exceeded.
+    */
+   void Spill()
+   {
+      if (!IsSpilled())
+      {
+         assert(mSpill.empty() && "Spilled moves should have been cleared.");
+         mSpill.assign(mInline.begin(), mInline.begin() + mSize);
+      }
+   }
+
+   /**
+    * @brief      Moves the moves back inline once they fit again.
+    */
+   void Unspill()
+   {
+      if (!IsSpilled() && !mSpill.empty())
+      {
+         std::copy(mSpill.begin(), mSpill.begin() + mSize, mInline.begin());
+         mSpill.clear();
+      }
+   }
+
+   std::array<eCubeMove, TInlineCapacity> mInline;
+   std::vector<eCubeMove> mSpill;
+   size_t mSize = 0;
+};
+}   // namespace cube
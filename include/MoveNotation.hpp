@@ -0,0 +1,328 @@
+#pragma once
+
+#include "Cube.hpp"
+#include "CubeMoves.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+namespace cube
+{
+// The first character of each group of 3 moves in eCubeMove: faces, wide faces, slices and
+// rotations. Upper case faces followed by 'w' are wide as well.
+constexpr std::string_view MoveFamilyChars = "UDRLFBudrlfbMESxyz";
+constexpr int NumWideFamilies = 6;
+
+/**
+ * @brief      Per character lookup for the lexer: the move family the character starts, NoFamily
+ * for the other characters of a move and NotNotation for separators.
+ */
+struct tNotationChars
+{
+   static constexpr int8_t NoFamily = -1;
+   static constexpr int8_t NotNotation = -2;
+
+   std::array<int8_t, 256> Families;
+};
+
+constexpr tNotationChars NotationChars = []()
+{
+   tNotationChars result = {};
+   result.Families.fill(tNotationChars::NotNotation);
+   for (char c : std::string_view("w'2"))
+   {
+      result.Families[static_cast<unsigned char>(c)] = tNotationChars::NoFamily;
+   }
+
+   for (size_t family = 0; family < MoveFamilyChars.size(); family++)
+   {
+      result.Families[static_cast<unsigned char>(MoveFamilyChars[family])] =
+         static_cast<int8_t>(family);
+   }
+
+   return result;
+}();
+
+/**
+ * @brief      Returns true if the character can be part of a move. Every other character separates
+ * moves, so "R U", "R,U" and "(R)(U)" all hold two moves.
+ */
+[[nodiscard]] constexpr bool IsNotationChar(char c)
+{
+   return NotationChars.Families[static_cast<unsigned char>(c)] != tNotationChars::NotNotation;
+}
+
+/**
+ * @brief      Decodes a single move. The first character picks the group of 3 moves in eCubeMove,
+ * a 'w' after an upper case face makes it wide and the modifier picks clockwise, prime or double.
+ *
+ * @param[in]  token  The move, without separators
+ * @param      move   The move
+ *
+ * @return     True if the token is a valid move.
+ */
+[[nodiscard]] constexpr bool ParseMoveToken(std::string_view token, eCubeMove& move)
+{
+   if (token.empty())
+   {
+      return false;
+   }
+
+   int family = NotationChars.Families[static_cast<unsigned char>(token[0])];
+   if (family < 0)
+   {
+      return false;
+   }
+
+   std::string_view modifier = token.substr(1);
+   if (family < NumWideFamilies && !modifier.empty() && modifier[0] == 'w')
+   {
+      family += NumWideFamilies;
+      modifier.remove_prefix(1);
+   }
+
+   // Every family is clockwise, prime then double in eCubeMove.
+   int variant;
+   if (modifier.empty())
+   {
+      variant = 0;
+   }
+   else if (modifier == "'")
+   {
+      variant = 1;
+   }
+   else if (modifier == "2")
+   {
+      variant = 2;
+   }
+   else
+   {
+      return false;
+   }
+
+   move = static_cast<eCubeMove>(family * 3 + variant);
+   return true;
+}
+
+/**
+ * @brief      Parses moves into the given buffer, see Cube::ParseMoveNotation. Stops at the first
+ * invalid move or when the buffer is full. Nothing is allocated, so this also runs at compile
+ * time.
+ *
+ * @param[in]  moveNotation  The move notation
+ * @param      moves         The buffer the moves are written to
+ *
+ * @return     The number of moves written and the first error.
+ */
+[[nodiscard]] constexpr tNotationResult ParseMoveNotation(
+   std::string_view moveNotation, std::span<eCubeMove> moves)
+{
+   tNotationResult result = {};
+   size_t pos = 0;
+   while (pos < moveNotation.size())
+   {
+      if (!IsNotationChar(moveNotation[pos]))
+      {
+         pos++;
+         continue;
+      }
+
+      size_t start = pos;
+      while (pos < moveNotation.size() && IsNotationChar(moveNotation[pos]))
+      {
+         pos++;
+      }
+
+      eCubeMove move;
+      if (!ParseMoveToken(moveNotation.substr(start, pos - start), move))
+      {
+         result.Error = eNotationError::InvalidMove;
+      }
+      else if (result.NumMoves == moves.size())
+      {
+         result.Error = eNotationError::BufferTooSmall;
+      }
+      else
+      {
+         moves[result.NumMoves++] = move;
+         continue;
+      }
+
+      result.ErrorOffset = start;
+      result.ErrorLength = pos - start;
+      return result;
+   }
+
+   return result;
+}
+
+/**
+ * @return     The most moves a notation of the given length can hold, enough room to parse it.
+ */
+[[nodiscard]] constexpr size_t GetMaxNotationMoves(size_t notationLength)
+{
+   // Moves are at least one character and separated by at least one more.
+   return (notationLength + 1) / 2;
+}
+
+/**
+ * @brief      The serialized form of one move: the token followed by a space, padded to a fixed
+ * size so it can be copied without looking at its length.
+ */
+struct tMoveToken
+{
+   // The longest token is a wide prime or double move like "Uw' ".
+   static constexpr size_t MaxLength = 4;
+
+   std::array<char, MaxLength> Chars;
+   uint8_t Length;
+};
+
+/**
+ * @brief      The token of every move in eCubeMove order. Wide moves use the upper case form, so
+ * "Uw" rather than "u".
+ */
+constexpr std::array<tMoveToken, NumMoves> MoveTokens = []()
+{
+   std::array<tMoveToken, NumMoves> result = {};
+   for (int move = 0; move < NumMoves; move++)
+   {
+      int family = move / 3;
+      tMoveToken& token = result[move];
+      token.Chars.fill(' ');
+      if (family >= NumWideFamilies && family < 2 * NumWideFamilies)
+      {
+         token.Chars[token.Length++] = MoveFamilyChars[family - NumWideFamilies];
+         token.Chars[token.Length++] = 'w';
+      }
+      else
+      {
+         token.Chars[token.Length++] = MoveFamilyChars[family];
+      }
+
+      // Every family is clockwise, prime then double in eCubeMove.
+      if (move % 3 != 0)
+      {
+         token.Chars[token.Length++] = move % 3 == 1 ? '\'' : '2';
+      }
+
+      token.Length++;
+   }
+
+   return result;
+}();
+
+// Written for moves that aren't in the table.
+constexpr tMoveToken InvalidMoveToken = { { '?', '?', ' ', ' ' }, 3 };
+
+// Separator mode writes "- " before every group of this many moves but the first.
+constexpr size_t MovesPerSeparator = 5;
+constexpr std::string_view MoveSeparator = "- ";
+
+/**
+ * @return     The largest number of characters the given number of moves serializes to, enough
+ * room for SerializeMoveList.
+ */
+[[nodiscard]] constexpr size_t GetMaxSerializedLength(size_t numMoves)
+{
+   size_t numSeparators = numMoves == 0 ? 0 : (numMoves - 1) / MovesPerSeparator;
+   return numMoves * tMoveToken::MaxLength + numSeparators * MoveSeparator.size();
+}
+
+/**
+ * @brief      Writes moves into the given buffer, see Cube::SerializeMoveList. Every move is
+ * followed by a space. Stops before the first move that doesn't fit, nothing is ever cut in half.
+ *
+ * @param[in]  moves              The moves
+ * @param      buffer             The buffer the characters are written to
+ * @param[in]  includeSeparators  True to write "- " between groups of 5 moves
+ *
+ * @return     The number of characters written.
+ */
+constexpr size_t SerializeMoveList(
+   std::span<const eCubeMove> moves, std::span<char> buffer, bool includeSeparators)
+{
+   size_t length = 0;
+   for (size_t i = 0; i < moves.size(); i++)
+   {
+      size_t move = static_cast<size_t>(EnumToInt(moves[i]));
+      const tMoveToken& token = move < MoveTokens.size() ? MoveTokens[move] : InvalidMoveToken;
+      bool writeSeparator = includeSeparators && i > 0 && i % MovesPerSeparator == 0;
+      size_t separatorLength = writeSeparator ? MoveSeparator.size() : 0;
+      if (length + separatorLength + token.Length > buffer.size())
+      {
+         break;
+      }
+
+      if (writeSeparator)
+      {
+         std::copy(MoveSeparator.begin(), MoveSeparator.end(), buffer.begin() + length);
+         length += separatorLength;
+      }
+
+      // Copy the whole padded token when there's room for it, the padding is overwritten next.
+      size_t copyLength =
+         length + tMoveToken::MaxLength <= buffer.size() ? tMoveToken::MaxLength : token.Length;
+      std::copy_n(token.Chars.begin(), copyLength, buffer.begin() + length);
+      length += token.Length;
+   }
+
+   return length;
+}
+
+/**
+ * @return     The number of moves in the notation, valid or not.
+ */
+[[nodiscard]] constexpr size_t CountNotationMoves(std::string_view moveNotation)
+{
+   size_t numMoves = 0;
+   for (size_t pos = 0; pos < moveNotation.size(); pos++)
+   {
+      bool startsMove = pos == 0 || !IsNotationChar(moveNotation[pos - 1]);
+      numMoves += startsMove && IsNotationChar(moveNotation[pos]);
+   }
+
+   return numMoves;
+}
+
+/**
+ * @brief      A string literal usable as a template argument, see operator""_moves.
+ */
+template <size_t N>
+struct tNotationLiteral
+{
+   consteval tNotationLiteral(const char (&notation)[N])
+   {
+      std::copy_n(notation, N, Chars.begin());
+   }
+
+   constexpr std::string_view GetNotation() const
+   {
+      return { Chars.data(), N - 1 };
+   }
+
+   std::array<char, N> Chars;
+};
+
+/**
+ * @brief      Parses move notation at compile time, "R U R' U'"_moves is a constant
+ * std::array<eCubeMove, 4>. Invalid notation doesn't compile.
+ *
+ * @return     The moves.
+ */
+template <tNotationLiteral TNotation>
+consteval auto operator""_moves()
+{
+   std::array<eCubeMove, CountNotationMoves(TNotation.GetNotation())> moves = {};
+   tNotationResult result = ParseMoveNotation(TNotation.GetNotation(), moves);
+   if (result.Error != eNotationError::None)
+   {
+      throw "Invalid move notation.";
+   }
+
+   return moves;
+}
+}   // namespace cube
@@ -0,0 +1,316 @@
+#pragma once
+
+#include "Cube.hpp"
+#include "CubeGeometry.hpp"
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace cube
+{
+/**
+ * @brief      A turn of a range of layers around an axis, for any cube size. Layers are counted
+ * from the negative end of the axis, so on an NxN cube L is layer 0 and R is layer N - 1 of the X
+ * axis. Quarter turns follow the right hand rule like every other move descriptor: counter
+ * clockwise when looking at the axis from its positive end.
+ */
+struct tLayerMove
+{
+   eCubeAxis Axis;
+   uint8_t FirstLayer;
+   uint8_t LastLayer;
+   uint8_t QuarterTurns;
+
+   constexpr bool operator==(const tLayerMove& other) const = default;
+};
+
+/**
+ * @brief      Parses moves in the notation of big cubes, see Cube::ParseMoveNotation. On top of the
+ * 3x3 moves this supports inner slices with a layer number before the face (2R is the second layer
+ * from R), wide moves of any depth (3Uw turns the 3 layers closest to U, Uw and u turn 2) and
+ * M, E and S on odd sized cubes. Invalid moves are skipped and reported in the result.
+ *
+ * @param[in]  moveNotation  The move notation
+ * @param[in]  cubeSize      The number of layers of the cube
+ * @param      moves         The parsed moves are appended here
+ *
+ * @return     The number of moves appended, the first invalid move and how many were skipped.
+ */
+tNotationResult ParseLayerMoveNotation(
+   std::string_view moveNotation, int cubeSize, std::vector<tLayerMove>& moves);
+
+/**
+ * @brief      Parses a single move, see ParseLayerMoveNotation.
+ *
+ * @param[in]  token     The move
+ * @param[in]  cubeSize  The number of layers of the cube
+ * @param      move      The move
+ *
+ * @return     True if the move is valid on a cube of that size, false otherwise.
+ */
+bool ParseLayerMove(std::string_view token, int cubeSize, tLayerMove& move);
+
+/**
+ * @brief      A cube of any size. Stickers are indexed per face exactly like Cube::GetState, and
+ * the kernel turning each layer is built at compile time for the size, so the loops run over a
+ * fixed number of stickers.
+ *
+ * Every quarter turn of a layer splits its stickers into cycles of 4 that each move one step
+ * around the axis. A layer move of 1, 2 or 3 quarter turns rotates each cycle by that many steps
+ * in place. Cube remains the implementation for 3x3 solving, it carries tables (orientations,
+ * cubies, byte shuffles) that only make sense for that size.
+ */
+template <int N>
+class NxNCube
+{
+public:
+   static_assert(N >= 2, "A cube needs at least 2 layers.");
+
+   static constexpr int Size = N;
+   static constexpr int FaceStickers = N * N;
+   static constexpr int NumStickers = EnumToInt(eCubeFace::NumFaces) * FaceStickers;
+
+   /**
+    * @brief      Standard constructor. The cube starts solved.
+    */
+   NxNCube()
+   {
+      SetSolved();
+   }
+
+   /**
+    * @brief      Sets the cube to the default solved state.
+    */
+   void SetSolved()
+   {
+      for (int sticker = 0; sticker < NumStickers; sticker++)
+      {
+         eCubeFace face = static_cast<eCubeFace>(sticker / FaceStickers);
+         mStickers[sticker] = Cube::DefaultColorOfFace(face);
+      }
+   }
+
+   /**
+    * @brief      Returns true if the cube is in a solved state, every face a single color.
+    */
+   bool IsSolved() const
+   {
+      for (int face = 0; face < EnumToInt(eCubeFace::NumFaces); face++)
+      {
+         for (int idx = 1; idx < FaceStickers; idx++)
+         {
+            if (mStickers[face * FaceStickers + idx] != mStickers[face * FaceStickers])
+            {
+               return false;
+            }
+         }
+      }
+
+      return true;
+   }
+
+   /**
+    * @return     The color state at the given position. See Cube::GetState for the indexing scheme,
+    * x and y go from 0 to N - 1.
+    */
+   inline eCubeColor GetState(eCubeFace face, int x, int y) const
+   {
+      return mStickers[StickerOf(face, x, y)];
+   }
+
+   /**
+    * @brief      Sets a single sticker, no validation.
+    */
+   inline void SetState(eCubeFace face, int x, int y, eCubeColor color)
+   {
+      mStickers[StickerOf(face, x, y)] = color;
+   }
+
+   /**
+    * @brief      Executes a single move.
+    *
+    * @param[in]  move  The move
+    */
+   void ExecuteMove(const tLayerMove& move)
+   {
+      assert(move.FirstLayer <= move.LastLayer && move.LastLayer < N && "Invalid layers.");
+
+      int quarterTurns = move.QuarterTurns % 4;
+      if (quarterTurns == 0)
+      {
+         return;
+      }
+
+      for (int layer = move.FirstLayer; layer <= move.LastLayer; layer++)
+      {
+         const tLayerCycles& cycles = sLayerCycles[EnumToInt(move.Axis) * N + layer];
+         for (int i = 0; i < cycles.NumCycles; i++)
+         {
+            const std::array<uint16_t, 4>& cycle = cycles.Cycles[i];
+            std::array<eCubeColor, 4> colors = { mStickers[cycle[0]], mStickers[cycle[1]],
+               mStickers[cycle[2]], mStickers[cycle[3]] };
+            for (int step = 0; step < 4; step++)
+            {
+               mStickers[cycle[(step + quarterTurns) & 3]] = colors[step];
+            }
+         }
+      }
+   }
+
+   /**
+    * @brief      Executes a series of moves.
+    *
+    * @param[in]  moves  The moves
+    */
+   void ExecuteMoves(const std::vector<tLayerMove>& moves)
+   {
+      for (const tLayerMove& move : moves)
+      {
+         ExecuteMove(move);
+      }
+   }
+
+   /**
+    * @brief      Parses moves for this size, see ParseLayerMoveNotation.
+    *
+    * @param[in]  moveNotation  The move notation
+    * @param      moves         The parsed moves are appended here
+    *
+    * @return     The number of moves appended, the first invalid move and how many were skipped.
+    */
+   static tNotationResult ParseMoveNotation(
+      std::string_view moveNotation, std::vector<tLayerMove>& moves)
+   {
+      return ParseLayerMoveNotation(moveNotation, N, moves);
+   }
+
+   bool operator==(const NxNCube& other) const
+   {
+      return mStickers == other.mStickers;
+   }
+
+private:
+   // Every layer has N cycles on its edges, the outer layers also turn a face.
+   static constexpr int MaxCycles = N + FaceStickers / 4;
+
+   /**
+    * @brief      The stickers of one layer grouped by the quarter turn. The sticker in Cycles[i][k]
+    * moves to Cycles[i][k + 1].
+    */
+   struct tLayerCycles
+   {
+      std::array<std::array<uint16_t, 4>, MaxCycles> Cycles;
+      int NumCycles;
+   };
+
+   [[nodiscard]] static constexpr int StickerOf(eCubeFace face, int x, int y)
+   {
+      return EnumToInt(face) * FaceStickers + y * N + x;
+   }
+
+   /**
+    * @brief      Places a sticker in space like GetStickerGeometry does for 3x3, with every
+    * coordinate doubled so even sizes stay on integers: pieces are at -(N - 1), -(N - 3) ... N - 1.
+    */
+   [[nodiscard]] static constexpr tStickerGeometry GetGeometry(int sticker)
+   {
+      constexpr int edge = N - 1;
+      int x = 2 * (sticker % FaceStickers % N) - edge;
+      int y = 2 * (sticker % FaceStickers / N) - edge;
+
+      switch (static_cast<eCubeFace>(sticker / FaceStickers))
+      {
+      case eCubeFace::Top:
+         return { { x, edge, y }, { 0, 1, 0 } };
+      case eCubeFace::Bottom:
+         return { { x, -edge, -y }, { 0, -1, 0 } };
+      case eCubeFace::Left:
+         return { { -edge, -y, x }, { -1, 0, 0 } };
+      case eCubeFace::Right:
+         return { { edge, -y, -x }, { 1, 0, 0 } };
+      case eCubeFace::Front:
+         return { { x, -y, edge }, { 0, 0, 1 } };
+      default:
+         return { { -x, -y, -edge }, { 0, 0, -1 } };
+      }
+   }
+
+   /**
+    * @brief      The inverse of GetGeometry.
+    */
+   [[nodiscard]] static constexpr int FindSticker(const tStickerGeometry& geometry)
+   {
+      constexpr int edge = N - 1;
+      const tVec3& position = geometry.Position;
+
+      if (geometry.Normal.Y != 0)
+      {
+         return geometry.Normal.Y > 0
+                   ? StickerOf(eCubeFace::Top, (position.X + edge) / 2, (position.Z + edge) / 2)
+                   : StickerOf(eCubeFace::Bottom, (position.X + edge) / 2, (edge - position.Z) / 2);
+      }
+
+      if (geometry.Normal.X != 0)
+      {
+         return geometry.Normal.X > 0
+                   ? StickerOf(eCubeFace::Right, (edge - position.Z) / 2, (edge - position.Y) / 2)
+                   : StickerOf(eCubeFace::Left, (position.Z + edge) / 2, (edge - position.Y) / 2);
+      }
+
+      return geometry.Normal.Z > 0
+                ? StickerOf(eCubeFace::Front, (position.X + edge) / 2, (edge - position.Y) / 2)
+                : StickerOf(eCubeFace::Back, (edge - position.X) / 2, (edge - position.Y) / 2);
+   }
+
+   [[nodiscard]] static constexpr tLayerCycles BuildLayerCycles(eCubeAxis axis, int layer)
+   {
+      tLayerCycles result = {};
+      std::array<bool, NumStickers> visited = {};
+      for (int sticker = 0; sticker < NumStickers; sticker++)
+      {
+         tStickerGeometry geometry = GetGeometry(sticker);
+         if (visited[sticker] || geometry.Position.Along(axis) != 2 * layer - (N - 1))
+         {
+            continue;
+         }
+
+         std::array<uint16_t, 4> cycle = {};
+         for (int step = 0; step < 4; step++)
+         {
+            int current = FindSticker(geometry);
+            cycle[step] = static_cast<uint16_t>(current);
+            visited[current] = true;
+            geometry.Position = geometry.Position.RotateQuarter(axis);
+            geometry.Normal = geometry.Normal.RotateQuarter(axis);
+         }
+
+         // The center of an odd face turns in place.
+         if (cycle[1] != cycle[0])
+         {
+            result.Cycles[result.NumCycles++] = cycle;
+         }
+      }
+
+      return result;
+   }
+
+   static constexpr std::array<tLayerCycles, 3 * N> sLayerCycles = []()
+   {
+      std::array<tLayerCycles, 3 * N> result = {};
+      for (int axis = 0; axis < 3; axis++)
+      {
+         for (int layer = 0; layer < N; layer++)
+         {
+            result[axis * N + layer] = BuildLayerCycles(static_cast<eCubeAxis>(axis), layer);
+         }
+      }
+
+      return result;
+   }();
+
+   std::array<eCubeColor, NumStickers> mStickers;
+};
+}   // namespace cube
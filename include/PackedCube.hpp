@@ -0,0 +1,149 @@
+#pragma once
+
+#include "Cube.hpp"
+
+#include <array>
+#include <cstdint>
+
+namespace cube
+{
+/**
+ * @brief      Compact alternative to Cube. Every sticker is stored as a 3 bit color code and each
+ * face is packed into a single 32 bit word, so the whole cube takes 24 bytes instead of 384.
+ *
+ * The 8 outer stickers of a face are stored clockwise starting from the top left corner
+ * (3 bits each, bits 0-23) and the center lives in bits 24-26. Storing the ring in clockwise order
+ * means turning a face is a rotation of the ring, and moving a strip of stickers from one face to
+ * another is a mask and a rotation.
+ */
+class PackedCube
+{
+public:
+   using PackedFace = uint32_t;
+
+   /**
+    * @brief      Standard constructor. The cube starts solved.
+    */
+   PackedCube();
+
+   /**
+    * @brief      Packs the state of the given cube.
+    *
+    * @param[in]  cube  The cube
+    */
+   explicit PackedCube(const Cube& cube);
+
+   /**
+    * @brief      Sets the cube to the default solved state.
+    */
+   void SetSolved();
+
+   /**
+    * @brief      Returns true if the cube is in a solved state.
+    *
+    * @return     True if solved, False otherwise.
+    */
+   bool IsSolved() const;
+
+   /**
+    * @brief      Executes a single move.
+    *
+    * @param[in]  move  The move
+    */
+   void ExecuteMove(eCubeMove move);
+
+   /**
+    * @brief      Executes a series of moves
+    *
+    * @param      move      The move
+    * @param[in]  numMoves  The number moves
+    */
+   void ExecuteMoves(const eCubeMove* moves, size_t numMoves);
+
+   /**
+    * @brief      Writes the unpacked state into the given cube.
+    *
+    * @param      cube  The cube
+    */
+   void Unpack(Cube& cube) const;
+
+   /**
+    * @brief      Returns the color at a given index of the cube. See Cube::GetState for the
+    * indexing scheme.
+    *
+    * @return     The color state at the given position.
+    */
+   inline eCubeColor GetState(eCubeFace face, int x, int y) const
+   {
+      int shift = StickerShift(CubeDimsToIdx(x, y));
+      return static_cast<eCubeColor>((mFaces[EnumToInt(face)] >> shift) & StickerMask);
+   }
+
+   /**
+    * @brief      Sets the color at the face and the X Y coordinates given. For the indexing
+    * scheme, see Cube::GetState.
+    *
+    * @param[in]  face   The face
+    * @param[in]  x      The new value
+    * @param[in]  y      The new value
+    * @param[in]  color  The color
+    */
+   inline void SetState(eCubeFace face, int x, int y, eCubeColor color)
+   {
+      int shift = StickerShift(CubeDimsToIdx(x, y));
+      PackedFace& packedFace = mFaces[EnumToInt(face)];
+      packedFace = (packedFace & ~(StickerMask << shift)) |
+                   (static_cast<PackedFace>(EnumToInt(color)) << shift);
+   }
+
+   /**
+    * @brief      Returns the current color associated with the given face.
+    *
+    * @param[in]  face  The face
+    *
+    * @return     The cube color.
+    */
+   inline eCubeColor ColorOfFace(eCubeFace face) const
+   {
+      return static_cast<eCubeColor>((mFaces[EnumToInt(face)] >> CenterShift) & StickerMask);
+   }
+
+   /**
+    * @return     The raw packed word for the given face.
+    */
+   inline PackedFace GetPackedFace(eCubeFace face) const
+   {
+      return mFaces[EnumToInt(face)];
+   }
+
+   bool operator==(const PackedCube& other) const = default;
+
+   static constexpr int BitsPerSticker = 3;
+   static constexpr int RingStickers = 8;
+   static constexpr int CenterShift = RingStickers * BitsPerSticker;
+   static constexpr PackedFace StickerMask = 0x7;
+   static constexpr PackedFace RingMask = 0xFFFFFF;
+
+   /**
+    * @return     The bit offset of the sticker at the given face index (see CubeDimsToIdx).
+    */
+   [[nodiscard]] static constexpr int StickerShift(int faceIdx)
+   {
+      // Clockwise from the top left corner with the center last.
+      constexpr std::array<int, CubeSize * CubeSize> ringSlot = { 0, 1, 2, 7, 8, 3, 6, 5, 4 };
+      return ringSlot[faceIdx] * BitsPerSticker;
+   }
+
+   /**
+    * @return     A face word with every sticker set to the given color.
+    */
+   [[nodiscard]] static constexpr PackedFace SolidFace(eCubeColor color)
+   {
+      // One bit at the bottom of each of the 9 sticker slots.
+      return static_cast<PackedFace>(EnumToInt(color)) * 0x1249249;
+   }
+
+private:
+   std::array<PackedFace, EnumToInt(eCubeFace::NumFaces)> mFaces;
+};
+}   // namespace cube
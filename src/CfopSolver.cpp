@@ -1,29 +1,34 @@
 #include "Cube.hpp"
+#include "CubePredicates.hpp"
 #include "CubeSolver.hpp"
+#include "MoveNotation.hpp"
 
+#include <array>
 #include <bitset>
 #include <cassert>
+#include <span>
 #include <string>
 #include <tuple>
 #include <vector>
 
-#define CUBE_ALG_DEF(name, moves)                           \
-   static const std::vector<eCubeMove>& name()              \
-   {                                                        \
-      static auto result = GenerateMoves(moves)();          \
-      return result;                                        \
+#define CUBE_ALG_DEF(name, moves)                                                     \
+   static const CompiledAlgorithm& name()                                             \
+   {                                                                                  \
+      static constexpr auto notationMoves = moves##_moves;                            \
+      static const CompiledAlgorithm result(notationMoves.data(), notationMoves.size()); \
+      return result;                                                                  \
    }
 
 #define CUBE_OLL_DEF(name, moves, topFace, frontFace, rightFace, backFace, leftFace) \
    static const tOLLPattern& name()                                                  \
    {                                                                                 \
-      static std::vector<eCubeMove> solve = GenerateMoves(moves)();                  \
-      static tOLLPattern pattern(std::bitset<9>(topFace),                            \
-                                 std::bitset<3>(frontFace),                          \
-                                 std::bitset<3>(rightFace),                          \
-                                 std::bitset<3>(backFace),                           \
-                                 std::bitset<3>(leftFace),                           \
-                                 solve);                                             \
+      static constexpr auto solve = moves##_moves;                                   \
+      static const tOLLPattern pattern(std::bitset<9>(topFace),                      \
+                                       std::bitset<3>(frontFace),                    \
+                                       std::bitset<3>(rightFace),                    \
+                                       std::bitset<3>(backFace),                     \
+                                       std::bitset<3>(leftFace),                     \
+                                       solve);                                       \
       return pattern;                                                                \
    }
 
@@ -31,16 +36,6 @@ namespace cube
 {
    constexpr eCubeColor BottomColor = Cube::DefaultColorOfFace(eCubeFace::Bottom);
 
-   static auto GenerateMoves(const std::string& moveNotation)
-   {
-      return [moveNotation]()
-      {
-         std::vector<eCubeMove> moves;
-         Cube::ParseMoveNotation(moveNotation, moves);
-         return moves;
-      };
-   }
-
    class FirstTwoLayersAlgorithms
    {
    public:
@@ -119,12 +114,12 @@ namespace cube
        *
        * @param[in]  pattern  The pattern
        */
-      constexpr tOLLPattern(std::bitset<9> top, std::bitset<3> front, 
+      tOLLPattern(std::bitset<9> top, std::bitset<3> front, 
          std::bitset<3> right, std::bitset<3> back, std::bitset<3> left,
-         std::vector<eCubeMove>& moves)
+         std::span<const eCubeMove> moves)
          : mTop(top.to_string()), 
            mFront(front.to_string()), mRight(right.to_string()), mBack(back.to_string()), mLeft(left.to_string()),
-           mMoves(moves)
+           mAlgorithm(moves.data(), moves.size())
       {
          // Validate, there should be a total of 9 ones.
          int count = 0;
@@ -190,7 +185,7 @@ namespace cube
          // Check the OLL for a match at the current layer.
          if (CheckMatch(cube))
          {
-            moveList.PushMoves(mMoves);
+            moveList.PushMoves(mAlgorithm);
             return true;
          }
 
@@ -215,12 +210,12 @@ namespace cube
       const std::string mRight;
       const std::string mBack;
       const std::string mLeft;
-      const std::vector<eCubeMove> mMoves;
+      const CompiledAlgorithm mAlgorithm;
    };
 
-   static tOLLPattern CreateOLLPattern(int top, int front, int right, int back, int left, const std::string& moves)
+   static tOLLPattern CreateOLLPattern(int top, int front, int right, int back, int left,
+      std::span<const eCubeMove> solve)
    {
-      std::vector<eCubeMove> solve = GenerateMoves(moves)();
       return tOLLPattern(std::bitset<9>(top), 
                          std::bitset<3>(front), 
                          std::bitset<3>(right), 
@@ -229,6 +224,49 @@ namespace cube
                          solve);
    }
 
+   /**
+    * @brief      Tries the patterns after every adjustment of the U face and executes the first one
+    * that matches. Each adjustment is tried from the state the search started in, moves pushed
+    * before the search are left alone.
+    *
+    * @param      cube      The cube
+    * @param      moveList  The move list
+    * @param[in]  patterns  The patterns
+    *
+    * @return     True if a pattern matched, its moves are left pending.
+    */
+   template <typename TPattern>
+   static bool PerformFirstMatchingAlg(
+      Cube& cube, CubeMoveList& moveList, const std::vector<TPattern>& patterns)
+   {
+      constexpr std::array<eCubeMove, 3> adjustments = {
+         eCubeMove::Up, eCubeMove::UpPrime, eCubeMove::Up2
+      };
+
+      size_t savepoint = moveList.CreateSavepoint();
+      for (size_t i = 0; i <= adjustments.size(); i++)
+      {
+         if (i > 0)
+         {
+            moveList.RollbackToSavepoint(savepoint);
+            moveList.PushMove(adjustments[i - 1]);
+         }
+
+         for (const TPattern& pattern : patterns)
+         {
+            if (pattern.PerformAlgIfMatches(cube, moveList))
+            {
+               moveList.ReleaseSavepoint(savepoint);
+               return true;
+            }
+         }
+      }
+
+      moveList.RollbackToSavepoint(savepoint);
+      moveList.ReleaseSavepoint(savepoint);
+      return false;
+   }
+
    /**
     * @brief      Defines algorithms and state matching used for OLL.
     */
@@ -237,7 +275,7 @@ namespace cube
    public:
       /**
        * @brief      Searches through the list of valid OLL patterns and executes the correct one
-       * to solve the oll. Rejects the current pending moves if it fails.
+       * to solve the oll. The pending moves are left as they were if it fails.
        *
        * @param      cube      The cube
        * @param      moveList  The move list
@@ -251,137 +289,100 @@ namespace cube
             std::vector<tOLLPattern> results 
             {
                // Awkward shape
-               CreateOLLPattern(0b011110001, 0b110, 0b010, 0b001, 0b000, "R U R' U' R U' R' F' U' F R U R'"), // OLL29
-               CreateOLLPattern(0b010110101, 0b010, 0b011, 0b000, 0b100, "F R' F R2 U' R' U' R U R' F2"),     // OLL30
-               CreateOLLPattern(0b010110101, 0b010, 0b010, 0b101, 0b000, "R U R' U R U2 R' F R U R' U' F'"),  // OLL41
-               CreateOLLPattern(0b101110010, 0b101, 0b010, 0b010, 0b000, "R' U' R U' R' U2 R F R U R' U' F'"), // OLL42
+               CreateOLLPattern(0b011110001, 0b110, 0b010, 0b001, 0b000, "R U R' U' R U' R' F' U' F R U R'"_moves), // OLL29
+               CreateOLLPattern(0b010110101, 0b010, 0b011, 0b000, 0b100, "F R' F R2 U' R' U' R U R' F2"_moves),     // OLL30
+               CreateOLLPattern(0b010110101, 0b010, 0b010, 0b101, 0b000, "R U R' U R U2 R' F R U R' U' F'"_moves),  // OLL41
+               CreateOLLPattern(0b101110010, 0b101, 0b010, 0b010, 0b000, "R' U' R U' R' U2 R F R U R' U' F'"_moves), // OLL42
 
                // Big lightning bolt
-               CreateOLLPattern(0b001111100, 0b010, 0b100, 0b011, 0b000,  "L F' L' U' L U F U' L'"), // OLL39
-               CreateOLLPattern(0b100111001, 0b010, 0b000, 0b110, 0b001,  "R' F R U R' U' F' U R"), // OLL40
+               CreateOLLPattern(0b001111100, 0b010, 0b100, 0b011, 0b000,  "L F' L' U' L U F U' L'"_moves), // OLL39
+               CreateOLLPattern(0b100111001, 0b010, 0b000, 0b110, 0b001,  "R' F R U R' U' F' U R"_moves), // OLL40
 
                // C shape
-               CreateOLLPattern(0b000111101, 0b010, 0b001, 0b010, 0b100, "R U R2 U' R' F R U R U' F'"), // OLL34
-               CreateOLLPattern(0b110010110, 0b000, 0b111, 0b000, 0b010, "R' U' R' F R F' U R"), // OLL46
+               CreateOLLPattern(0b000111101, 0b010, 0b001, 0b010, 0b100, "R U R2 U' R' F R U R U' F'"_moves), // OLL34
+               CreateOLLPattern(0b110010110, 0b000, 0b111, 0b000, 0b010, "R' U' R' F R F' U R"_moves), // OLL46
 
                // Corners oriented
-               CreateOLLPattern(0b111110101, 0b010, 0b010, 0b000, 0b000, "r U R' U' r' R U R U' R'"), // OLL28
-               CreateOLLPattern(0b101111101, 0b010, 0b000, 0b010, 0b000, "R U R' U' M' U R U' r'"), // OLL57
+               CreateOLLPattern(0b111110101, 0b010, 0b010, 0b000, 0b000, "r U R' U' r' R U R U' R'"_moves), // OLL28
+               CreateOLLPattern(0b101111101, 0b010, 0b000, 0b010, 0b000, "R U R' U' M' U R U' r'"_moves), // OLL57
 
                // Cross
-               CreateOLLPattern(0b010111010, 0b101, 0b000, 0b101, 0b000, "R U2 R' U' R U R' U' R U' R'"), // OLL21
-               CreateOLLPattern(0b010111010, 0b001, 0b000, 0b100, 0b101, "R U2 R2 U' R2 U' R2 U2 R"), // OLL22
-               CreateOLLPattern(0b010111111, 0b000, 0b000, 0b101, 0b000, "R2 D' R U2 R' D R U2 R"), // OLL23
-               CreateOLLPattern(0b011111011, 0b100, 0b000, 0b001, 0b000, "r U R' U' r' F R F'"), // OLL24
-               CreateOLLPattern(0b011111110, 0b001, 0b000, 0b000, 0b100, "F' r U R' U' r' F R"), // OLL25
-               CreateOLLPattern(0b011111010, 0b100, 0b100, 0b000, 0b100, "R U2 R' U' R U' R'"), // OLL26
-               CreateOLLPattern(0b010111110, 0b001, 0b001, 0b001, 0b000, "R U R' U R U2 R'"), // OLL27
+               CreateOLLPattern(0b010111010, 0b101, 0b000, 0b101, 0b000, "R U2 R' U' R U R' U' R U' R'"_moves), // OLL21
+               CreateOLLPattern(0b010111010, 0b001, 0b000, 0b100, 0b101, "R U2 R2 U' R2 U' R2 U2 R"_moves), // OLL22
+               CreateOLLPattern(0b010111111, 0b000, 0b000, 0b101, 0b000, "R2 D' R U2 R' D R U2 R"_moves), // OLL23
+               CreateOLLPattern(0b011111011, 0b100, 0b000, 0b001, 0b000, "r U R' U' r' F R F'"_moves), // OLL24
+               CreateOLLPattern(0b011111110, 0b001, 0b000, 0b000, 0b100, "F' r U R' U' r' F R"_moves), // OLL25
+               CreateOLLPattern(0b011111010, 0b100, 0b100, 0b000, 0b100, "R U2 R' U' R U' R'"_moves), // OLL26
+               CreateOLLPattern(0b010111110, 0b001, 0b001, 0b001, 0b000, "R U R' U R U2 R'"_moves), // OLL27
 
                // Dot
-               CreateOLLPattern(0b000010000, 0b010, 0b111, 0b010, 0b111, "R U2 R2 F R F' U2 R' F R F'"), // OLL01
-               CreateOLLPattern(0b000010000, 0b010, 0b110, 0b111, 0b011, "r U r' U2 r U2 R' U2 R U' r'"), // OLL02
-               CreateOLLPattern(0b000010100, 0b011, 0b011, 0b011, 0b010, "r' R2 U R' U r U2 r' U M'"), // OLL03
-               CreateOLLPattern(0b000010001, 0b110, 0b010, 0b110, 0b110, "M U' r U2 r' U' R U' R' M'"), // OLL04
-               CreateOLLPattern(0b100010001, 0b110, 0b011, 0b010, 0b010, "F R' F' R2 r' U R U' R' U' M'"), // OLL17
-               CreateOLLPattern(0b101010000, 0b111, 0b010, 0b010, 0b010, "r U R' U R U2 r2 U' R U' R' U2 r"), // OLL18
-               CreateOLLPattern(0b101010000, 0b010, 0b110, 0b010, 0b011, "r' R U R U R' U' M' R' F R F'"), // OLL19
-               CreateOLLPattern(0b101010101, 0b010, 0b010, 0b010, 0b010, "r U R' U' M2 U R U' R' U' M'"), // OLL20
+               CreateOLLPattern(0b000010000, 0b010, 0b111, 0b010, 0b111, "R U2 R2 F R F' U2 R' F R F'"_moves), // OLL01
+               CreateOLLPattern(0b000010000, 0b010, 0b110, 0b111, 0b011, "r U r' U2 r U2 R' U2 R U' r'"_moves), // OLL02
+               CreateOLLPattern(0b000010100, 0b011, 0b011, 0b011, 0b010, "r' R2 U R' U r U2 r' U M'"_moves), // OLL03
+               CreateOLLPattern(0b000010001, 0b110, 0b010, 0b110, 0b110, "M U' r U2 r' U' R U' R' M'"_moves), // OLL04
+               CreateOLLPattern(0b100010001, 0b110, 0b011, 0b010, 0b010, "F R' F' R2 r' U R U' R' U' M'"_moves), // OLL17
+               CreateOLLPattern(0b101010000, 0b111, 0b010, 0b010, 0b010, "r U R' U R U2 r2 U' R U' R' U2 r"_moves), // OLL18
+               CreateOLLPattern(0b101010000, 0b010, 0b110, 0b010, 0b011, "r' R U R U R' U' M' R' F R F'"_moves), // OLL19
+               CreateOLLPattern(0b101010101, 0b010, 0b010, 0b010, 0b010, "r U R' U' M2 U R U' R' U' M'"_moves), // OLL20
 
                // Fish shape
-               CreateOLLPattern(0b010110001, 0b110, 0b010, 0b100, 0b100, "R U R' U' R' F R2 U R' U' F'"), // OLL09
-               CreateOLLPattern(0b001110010, 0b001, 0b010, 0b011, 0b001, "R U R' U R' F R F' R U2 R'"), // OLL10
-               CreateOLLPattern(0b100011011, 0b100, 0b001, 0b010, 0b010, "R U2 R2 F R F' R U2 R'"), // OLL35
-               CreateOLLPattern(0b110110001, 0b110, 0b011, 0b000, 0b000, "F R' F' R U R U' R'"), // OLL37
+               CreateOLLPattern(0b010110001, 0b110, 0b010, 0b100, 0b100, "R U R' U' R' F R2 U R' U' F'"_moves), // OLL09
+               CreateOLLPattern(0b001110010, 0b001, 0b010, 0b011, 0b001, "R U R' U R' F R F' R U2 R'"_moves), // OLL10
+               CreateOLLPattern(0b100011011, 0b100, 0b001, 0b010, 0b010, "R U2 R2 F R F' R U2 R'"_moves), // OLL35
+               CreateOLLPattern(0b110110001, 0b110, 0b011, 0b000, 0b000, "F R' F' R U R U' R'"_moves), // OLL37
 
                // I shape
-               CreateOLLPattern(0b000111000, 0b110, 0b101, 0b011, 0b000, "F U R U' R' U R U' R' F'"), // OLL51
-               CreateOLLPattern(0b010010010, 0b100, 0b111, 0b001, 0b010, "R U R' U R U' B U' B' R'"), // OLL52
-               CreateOLLPattern(0b000111000, 0b111, 0b000, 0b111, 0b000, "R' F R U R U' R2 F' R2 U' R' U R U R'"), // OLL55
-               CreateOLLPattern(0b000111000, 0b010, 0b101, 0b010, 0b101, "r' U' r U' R' U R U' R' U R r' U r"), // OLL56
+               CreateOLLPattern(0b000111000, 0b110, 0b101, 0b011, 0b000, "F U R U' R' U R U' R' F'"_moves), // OLL51
+               CreateOLLPattern(0b010010010, 0b100, 0b111, 0b001, 0b010, "R U R' U R U' B U' B' R'"_moves), // OLL52
+               CreateOLLPattern(0b000111000, 0b111, 0b000, 0b111, 0b000, "R' F R U R U' R2 F' R2 U' R' U R U R'"_moves), // OLL55
+               CreateOLLPattern(0b000111000, 0b010, 0b101, 0b010, 0b101, "r' U' r U' R' U R U' R' U R r' U r"_moves), // OLL56
 
                // Knight move shape
-               CreateOLLPattern(0b000111100, 0b011, 0b001, 0b011, 0b000, "F U R U' R2 F' R U R U' R'"), // OLL13
-               CreateOLLPattern(0b000111001, 0b110, 0b000, 0b110, 0b100, "R' F R U R' F' R F U' F'"), // OLL14
-               CreateOLLPattern(0b100111000, 0b011, 0b001, 0b010, 0b001, "l' U' l L' U' L U l' U l"), // OLL15
-               CreateOLLPattern(0b001111000, 0b110, 0b100, 0b010, 0b100, "r U r' R U R' U' r U' r'"), // OLL16
+               CreateOLLPattern(0b000111100, 0b011, 0b001, 0b011, 0b000, "F U R U' R2 F' R U R U' R'"_moves), // OLL13
+               CreateOLLPattern(0b000111001, 0b110, 0b000, 0b110, 0b100, "R' F R U R' F' R F U' F'"_moves), // OLL14
+               CreateOLLPattern(0b100111000, 0b011, 0b001, 0b010, 0b001, "l' U' l L' U' L U l' U l"_moves), // OLL15
+               CreateOLLPattern(0b001111000, 0b110, 0b100, 0b010, 0b100, "r U r' R U R' U' r U' r'"_moves), // OLL16
 
                // P-Shape
-               CreateOLLPattern(0b011011001, 0b110, 0b000, 0b001, 0b010, "R' U' F U R U' R' F' R"), // OLL31
-               CreateOLLPattern(0b110110100, 0b011, 0b010, 0b100, 0b000, "L U F' U' L' U L F L'"), // OLL32
-               CreateOLLPattern(0b011011001, 0b010, 0b000, 0b000, 0b111, "F' U' L' U L F"), // OLL43
-               CreateOLLPattern(0b110110100, 0b010, 0b111, 0b000, 0b000, "F U R U' R' F'"), // OLL44
+               CreateOLLPattern(0b011011001, 0b110, 0b000, 0b001, 0b010, "R' U' F U R U' R' F' R"_moves), // OLL31
+               CreateOLLPattern(0b110110100, 0b011, 0b010, 0b100, 0b000, "L U F' U' L' U L F L'"_moves), // OLL32
+               CreateOLLPattern(0b011011001, 0b010, 0b000, 0b000, 0b111, "F' U' L' U L F"_moves), // OLL43
+               CreateOLLPattern(0b110110100, 0b010, 0b111, 0b000, 0b000, "F U R U' R' F'"_moves), // OLL44
 
                // Small L shape
-               CreateOLLPattern(0b010011000, 0b110, 0b101, 0b001, 0b010, "R' U' R' F R F' R' F R F' U R"), // OLL47
-               CreateOLLPattern(0b010110000, 0b011, 0b010, 0b100, 0b101, "F R U R' U' R U R' U' F'"), // OLL48
-               CreateOLLPattern(0b010011000, 0b011, 0b000, 0b100, 0b111, "r U' r2 U r2 U r2 U' r"), // OLL49
-               CreateOLLPattern(0b000011010, 0b001, 0b000, 0b110, 0b111, "r' U r2 U' r2 U' r2 U r'"), // OLL50
-               CreateOLLPattern(0b010011000, 0b111, 0b000, 0b101, 0b010, "l' U2 L U L' U' L U L' U l"), // OLL53
-               CreateOLLPattern(0b010110000, 0b111, 0b010, 0b101, 0b000, "r U2 R' U' R U R' U' R U' r'"), // OLL54
+               CreateOLLPattern(0b010011000, 0b110, 0b101, 0b001, 0b010, "R' U' R' F R F' R' F R F' U R"_moves), // OLL47
+               CreateOLLPattern(0b010110000, 0b011, 0b010, 0b100, 0b101, "F R U R' U' R U R' U' F'"_moves), // OLL48
+               CreateOLLPattern(0b010011000, 0b011, 0b000, 0b100, 0b111, "r U' r2 U r2 U r2 U' r"_moves), // OLL49
+               CreateOLLPattern(0b000011010, 0b001, 0b000, 0b110, 0b111, "r' U r2 U' r2 U' r2 U r'"_moves), // OLL50
+               CreateOLLPattern(0b010011000, 0b111, 0b000, 0b101, 0b010, "l' U2 L U L' U' L U L' U l"_moves), // OLL53
+               CreateOLLPattern(0b010110000, 0b111, 0b010, 0b101, 0b000, "r U2 R' U' R U R' U' R U' r'"_moves), // OLL54
 
                // Small lightning bolt
-               CreateOLLPattern(0b010110100, 0b011, 0b011, 0b001, 0b000, "r U R' U R U2 r'"), // OLL07
-               CreateOLLPattern(0b010011001, 0b110, 0b000, 0b100, 0b110, "l' U' L U' L' U2 l"), // OLL08
-               CreateOLLPattern(0b011110000, 0b011, 0b010, 0b001, 0b001, "r U R' U R' F R F' R U2 r'"), // OLL11
-               CreateOLLPattern(0b110011000, 0b110, 0b100, 0b100, 0b010, "M' R' U' R U' R' U2 R U' R r'"), // OLL12
+               CreateOLLPattern(0b010110100, 0b011, 0b011, 0b001, 0b000, "r U R' U R U2 r'"_moves), // OLL07
+               CreateOLLPattern(0b010011001, 0b110, 0b000, 0b100, 0b110, "l' U' L U' L' U2 l"_moves), // OLL08
+               CreateOLLPattern(0b011110000, 0b011, 0b010, 0b001, 0b001, "r U R' U R' F R F' R U2 r'"_moves), // OLL11
+               CreateOLLPattern(0b110011000, 0b110, 0b100, 0b100, 0b010, "M' R' U' R U' R' U2 R U' R r'"_moves), // OLL12
 
                // Square shape
-               CreateOLLPattern(0b110110000, 0b011, 0b011, 0b000, 0b001, "l' U2 L U L' U l"), // OLL05
-               CreateOLLPattern(0b011011000, 0b110, 0b100, 0b000, 0b110, "r U2 R' U' R U' r'"), // OLL06
+               CreateOLLPattern(0b110110000, 0b011, 0b011, 0b000, 0b001, "l' U2 L U L' U l"_moves), // OLL05
+               CreateOLLPattern(0b011011000, 0b110, 0b100, 0b000, 0b110, "r U2 R' U' R U' r'"_moves), // OLL06
 
                // T-Shape
-               CreateOLLPattern(0b001111001, 0b110, 0b000, 0b011, 0b000, "R U R' U' R' F R F'"), // OLL33
-               CreateOLLPattern(0b001111001, 0b010, 0b000, 0b010, 0b101, "F R U R' U' F'"), // OLL45
+               CreateOLLPattern(0b001111001, 0b110, 0b000, 0b011, 0b000, "R U R' U' R' F R F'"_moves), // OLL33
+               CreateOLLPattern(0b001111001, 0b010, 0b000, 0b010, 0b101, "F R U R' U' F'"_moves), // OLL45
 
                // W-Shape
-               CreateOLLPattern(0b110011001, 0b010, 0b000, 0b100, 0b011, "L' U' L U' L' U L U L F' L' F"), // OLL36
-               CreateOLLPattern(0b011110100, 0b010, 0b110, 0b001, 0b000, "R U R' U R U' R' U' R' F R F'"), // OLL38
+               CreateOLLPattern(0b110011001, 0b010, 0b000, 0b100, 0b011, "L' U' L U' L' U L U L F' L' F"_moves), // OLL36
+               CreateOLLPattern(0b011110100, 0b010, 0b110, 0b001, 0b000, "R U R' U R U' R' U' R' F R F'"_moves), // OLL38
             };
 
             return results;
          }();
 
-         // Check current orientation
-         for (int i = 0; i < allOLLs.size(); i++)
-         {
-            if (allOLLs[i].PerformAlgIfMatches(cube, moveList))
-            {
-               return true;
-            }
-         }
-
-         // Check rotation once
-         moveList.PushMove(eCubeMove::Up);
-         for (int i = 0; i < allOLLs.size(); i++)
-         {
-            if (allOLLs[i].PerformAlgIfMatches(cube, moveList))
-            {
-               return true;
-            }
-         }
-         moveList.RejectPendingMoves();
-
-         // Check rotation backwards
-         moveList.PushMove(eCubeMove::UpPrime);
-         for (int i = 0; i < allOLLs.size(); i++)
-         {
-            if (allOLLs[i].PerformAlgIfMatches(cube, moveList))
-            {
-               return true;
-            }
-         }
-         moveList.RejectPendingMoves();
-
-         // Check rotation backwards
-         moveList.PushMove(eCubeMove::Up2);
-         for (int i = 0; i < allOLLs.size(); i++)
+         if (PerformFirstMatchingAlg(cube, moveList, allOLLs))
          {
-            if (allOLLs[i].PerformAlgIfMatches(cube, moveList))
-            {
-               return true;
-            }
+            return true;
          }
-         moveList.RejectPendingMoves();
 
          assert(false && "Could not match OLL case");
          return false;
@@ -406,9 +407,9 @@ namespace cube
        * @param[in]  frontPattern  The front pattern
        */
       tPLLPattern(const std::string& frontPattern, const std::string& rightPattern, 
-         const std::string& backPattern, const std::string& leftPattern, const std::vector<eCubeMove>& solve)
+         const std::string& backPattern, const std::string& leftPattern, std::span<const eCubeMove> solve)
          : mFrontPattern(frontPattern), mRightPattern(rightPattern), mBackPattern(backPattern), mLeftPattern(leftPattern),
-         mSolve(solve)
+         mAlgorithm(solve.data(), solve.size())
       {
       }
 
@@ -449,7 +450,7 @@ namespace cube
          // Check the OLL for a match at the current layer.
          if (CheckMatch(cube))
          {
-            moveList.PushMoves(mSolve);
+            moveList.PushMoves(mAlgorithm);
             return true;
          }
 
@@ -499,13 +500,12 @@ namespace cube
       std::string mRightPattern;
       std::string mBackPattern;
       std::string mLeftPattern;
-      std::vector<eCubeMove> mSolve;
+      CompiledAlgorithm mAlgorithm;
    };
 
    static tPLLPattern CreatePLLPattern(const std::string& front, const std::string& right, 
-      const std::string& back, const std::string& left, const std::string& moves)
+      const std::string& back, const std::string& left, std::span<const eCubeMove> solve)
    {
-      std::vector<eCubeMove> solve = GenerateMoves(moves)();
       return tPLLPattern(front, right, back, left, solve);
    }
 
@@ -518,108 +518,42 @@ namespace cube
          {
             std::vector<tPLLPattern> results 
             {
-               CreatePLLPattern("LFF", "RRL", "FBR", "BLB", "x L2 D2 L' U' L D2 L' U L'"), // PLL_Aa
-               CreatePLLPattern("RFB", "LRR", "BBL", "FLF", "x' L2 D2 L U L' D2 L U' L"), // PLL_Ab
-               CreatePLLPattern("FBR", "BRF", "RFB", "LLL", "R' U' F' R U R' U' R' F R2 U' R' U' R U R' U R"), // PLL_F
-               CreatePLLPattern("FRR", "BLF", "RFB", "LBL", "R2 U R' U R' U' R U' R2 U' D R' U R D'"), // PLL_Ga
-               CreatePLLPattern("FBR", "BFF", "RLB", "LRL", "R' U' R U D' R2 U R' U R U' R U' R2 D"), // PLL_Gb
-               CreatePLLPattern("FBR", "BLF", "RRB", "LFL", "R2 U' R U' R U R' U R2 U D' R U' R' D"), // PLL_Gc
-               CreatePLLPattern("FLR", "BBF", "RFB", "LRL", "R U R' U' D R2 U' R U' R' U R' U R2 D'"), // PLL_Gd
-               CreatePLLPattern("FFR", "BBF", "RRB", "LLL", "x R2 F R F' R U2 r' U r U2"), // PLL_Ja
-               CreatePLLPattern("LFF", "RLL", "FRR", "BBB", "R U R' F' R U R' U' R' F R2 U' R'"), // PLL_Jb
-               CreatePLLPattern("LLF", "RFL", "FBR", "BRB", "R U' R' U' R U R D R' U' R D' R' U2 R'"), // PLL_Ra
-               CreatePLLPattern("RFB", "LBR", "BLL", "FRF", "R2 F R U R U' R' F' R U2 R' U2 R"), // PLL_Rb
-               CreatePLLPattern("FFR", "BLF", "RBB", "LRL", "R U R' U' R' F R2 U' R' U' R U R' F'"), // PLL_T
-               CreatePLLPattern("LFR", "BRF", "RBL", "FLB", "x' L' U L D' L' U' L D L' U' L D' L' U L D"), // PLL_E
-               CreatePLLPattern("BFF", "RLL", "FBB", "LRR", "R U R' U R U R' F' R U R' U' R' F R2 U' R' U2 R U' R'"), // PLL_Na
-               CreatePLLPattern("FFB", "LLR", "BBF", "RRL", "R' U R U' R' F' U' F R U R' F R' F' R U' R"), // PLL_Nb
-               CreatePLLPattern("FFB", "LBR", "BRF", "RLL", "R' U R' U' y R' F' R2 U' R' U R' F R F"), // PLL_V
-               CreatePLLPattern("FFB", "LRR", "BLF", "RBL", "F R U' R' U' R U R' F' R U R' U' R' F R F'"), // PLL_Y
-               CreatePLLPattern("FBF", "RLR", "BFB", "LRL", "M2 U M2 U2 M2 U M2"), // PLL_H
-               CreatePLLPattern("FRF", "RLR", "BBB", "LFL", "M2 U M U2 M' U M2"), // PLL_Ua
-               CreatePLLPattern("FLF", "RFR", "BBB", "LRL", "M2 U' M U2 M' U' M2"), // PLL_Ub
-               CreatePLLPattern("LBL", "FRF", "RFR", "BLB", "M' U M2 U M2 U M' U2 M2"), // PLL_Z
+               CreatePLLPattern("LFF", "RRL", "FBR", "BLB", "x L2 D2 L' U' L D2 L' U L'"_moves), // PLL_Aa
+               CreatePLLPattern("RFB", "LRR", "BBL", "FLF", "x' L2 D2 L U L' D2 L U' L"_moves), // PLL_Ab
+               CreatePLLPattern("FBR", "BRF", "RFB", "LLL", "R' U' F' R U R' U' R' F R2 U' R' U' R U R' U R"_moves), // PLL_F
+               CreatePLLPattern("FRR", "BLF", "RFB", "LBL", "R2 U R' U R' U' R U' R2 U' D R' U R D'"_moves), // PLL_Ga
+               CreatePLLPattern("FBR", "BFF", "RLB", "LRL", "R' U' R U D' R2 U R' U R U' R U' R2 D"_moves), // PLL_Gb
+               CreatePLLPattern("FBR", "BLF", "RRB", "LFL", "R2 U' R U' R U R' U R2 U D' R U' R' D"_moves), // PLL_Gc
+               CreatePLLPattern("FLR", "BBF", "RFB", "LRL", "R U R' U' D R2 U' R U' R' U R' U R2 D'"_moves), // PLL_Gd
+               CreatePLLPattern("FFR", "BBF", "RRB", "LLL", "x R2 F R F' R U2 r' U r U2"_moves), // PLL_Ja
+               CreatePLLPattern("LFF", "RLL", "FRR", "BBB", "R U R' F' R U R' U' R' F R2 U' R'"_moves), // PLL_Jb
+               CreatePLLPattern("LLF", "RFL", "FBR", "BRB", "R U' R' U' R U R D R' U' R D' R' U2 R'"_moves), // PLL_Ra
+               CreatePLLPattern("RFB", "LBR", "BLL", "FRF", "R2 F R U R U' R' F' R U2 R' U2 R"_moves), // PLL_Rb
+               CreatePLLPattern("FFR", "BLF", "RBB", "LRL", "R U R' U' R' F R2 U' R' U' R U R' F'"_moves), // PLL_T
+               CreatePLLPattern("LFR", "BRF", "RBL", "FLB", "x' L' U L D' L' U' L D L' U' L D' L' U L D"_moves), // PLL_E
+               CreatePLLPattern("BFF", "RLL", "FBB", "LRR", "R U R' U R U R' F' R U R' U' R' F R2 U' R' U2 R U' R'"_moves), // PLL_Na
+               CreatePLLPattern("FFB", "LLR", "BBF", "RRL", "R' U R U' R' F' U' F R U R' F R' F' R U' R"_moves), // PLL_Nb
+               CreatePLLPattern("FFB", "LBR", "BRF", "RLL", "R' U R' U' y R' F' R2 U' R' U R' F R F"_moves), // PLL_V
+               CreatePLLPattern("FFB", "LRR", "BLF", "RBL", "F R U' R' U' R U R' F' R U R' U' R' F R F'"_moves), // PLL_Y
+               CreatePLLPattern("FBF", "RLR", "BFB", "LRL", "M2 U M2 U2 M2 U M2"_moves), // PLL_H
+               CreatePLLPattern("FRF", "RLR", "BBB", "LFL", "M2 U M U2 M' U M2"_moves), // PLL_Ua
+               CreatePLLPattern("FLF", "RFR", "BBB", "LRL", "M2 U' M U2 M' U' M2"_moves), // PLL_Ub
+               CreatePLLPattern("LBL", "FRF", "RFR", "BLB", "M' U M2 U M2 U M' U2 M2"_moves), // PLL_Z
             };
 
             return results;
          }();
 
-         // Check current orientation
-         for (int i = 0; i < allPLLs.size(); i++)
-         {
-            if (allPLLs[i].PerformAlgIfMatches(cube, moveList))
-            {
-               return true;
-            }
-         }
-
-         // Check rotation once
-         moveList.PushMove(eCubeMove::Up);
-         for (int i = 0; i < allPLLs.size(); i++)
-         {
-            if (allPLLs[i].PerformAlgIfMatches(cube, moveList))
-            {
-               return true;
-            }
-         }
-         moveList.RejectPendingMoves();
-
-         // Check rotation backwards
-         moveList.PushMove(eCubeMove::UpPrime);
-         for (int i = 0; i < allPLLs.size(); i++)
-         {
-            if (allPLLs[i].PerformAlgIfMatches(cube, moveList))
-            {
-               return true;
-            }
-         }
-         moveList.RejectPendingMoves();
-
-         // Check rotation backwards
-         moveList.PushMove(eCubeMove::Up2);
-         for (int i = 0; i < allPLLs.size(); i++)
+         if (PerformFirstMatchingAlg(cube, moveList, allPLLs))
          {
-            if (allPLLs[i].PerformAlgIfMatches(cube, moveList))
-            {
-               return true;
-            }
+            return true;
          }
-         moveList.RejectPendingMoves();
 
          assert(false && "Could not match PLL case");
          return false;
       }
    };
 
-   /**
-    * @brief      Returns the face opposite to the given one (On the other side)
-    *
-    * @param[in]  face  The face
-    *
-    * @return     The opposite face.
-    */
-   static eCubeFace GetOppositeFace(eCubeFace face)
-   {
-      switch (face)
-      {
-      case eCubeFace::Front:
-         return eCubeFace::Back;
-      case eCubeFace::Back:
-         return eCubeFace::Front;
-      case eCubeFace::Left:
-         return eCubeFace::Right;
-      case eCubeFace::Right:
-         return eCubeFace::Left;
-      case eCubeFace::Top:
-         return eCubeFace::Bottom;
-      case eCubeFace::Bottom:
-         return eCubeFace::Top;
-      default:
-         assert(false);
-         return eCubeFace::Top;
-      }
-   }
-
    tCornerDescriptor CubeSolveUtils::GetCornerDescriptor(eCubeFace face, eFaceCornerPos corner)
    {
       switch (face)
@@ -858,7 +792,10 @@ namespace cube
          resultY = 2;
          break;
       default:
+         // Keep the lookups in range if this ever fires in a release build.
          assert(false);
+         resultX = 1;
+         resultY = 1;
          break;
       }
    }
@@ -885,6 +822,8 @@ namespace cube
          break;
       default:
          assert(false);
+         resultX = 1;
+         resultY = 1;
          break;
       }
    }
@@ -933,6 +872,16 @@ namespace cube
       GetEdgePosition(edgePos, faceX, faceY);
 
       eCubeColor face1Color = cube.GetState(face, faceX, faceY);
+      if (cube.GetPieceTracking())
+      {
+         if (face1Color == color1 || face1Color == color2)
+         {
+            isInverted = face1Color == color2;
+         }
+
+         return cube.IsPieceAt(color1, color2, face, faceX, faceY);
+      }
+
       if (face1Color == color1)
       {
          isInverted = false;
@@ -1062,7 +1011,7 @@ namespace cube
       if (moveList.GetNumMoves() > 0)
       {
          outputStream << "Orienting: ";
-         moveList.SerializeMoves(outputStream);
+         moveList.SerializeMoves(outputStream, useSeparators);
          outputStream << "\n";
          return true;
       }
@@ -1077,12 +1026,8 @@ namespace cube
     */
    static bool IsFaceCrossSolved(Cube& cube, eCubeFace face)
    {
-      eCubeColor faceColor = cube.ColorOfFace(face);
-      bool isInverted;
-      bool edgeInPosition = CubeSolveUtils::IsEdgeInPosition(cube, face, eFaceEdgePos::BottomEdge, 
-         faceColor, BottomColor, isInverted);
-
-      return edgeInPosition && !isInverted;
+      // The bottom center holds BottomColor once the cube is oriented.
+      return StickerPredicate::CrossEdge(face).Matches(cube);
    }
 
    /**
@@ -1456,7 +1401,7 @@ namespace cube
       if (moveList.GetNumMoves() > 0)
       {
          outputStream << "Cross: ";
-         moveList.SerializeMoves(outputStream);
+         moveList.SerializeMoves(outputStream, useSeparators);
          outputStream << "\n";
          return true;
       }
@@ -1469,160 +1414,9 @@ namespace cube
 
    #pragma region F2L
 
-   /**
-    * @return      Returns the face corner relative to sideFace1 such that the corner is adjacent to 
-    */
-   static eFaceCornerPos GetF2lPairCorner(Cube& cube, eCubeFace sideFace1, eCubeFace sideFace2)
-   {
-      assert(sideFace1 != eCubeFace::Top && sideFace1 != eCubeFace::Bottom);
-      assert(sideFace2 != eCubeFace::Top && sideFace2 != eCubeFace::Bottom);
-      assert(sideFace1 != sideFace2);
-      assert(GetOppositeFace(sideFace1) != sideFace2);
-
-      if (sideFace1 == eCubeFace::Front)
-      {
-         if (sideFace2 == eCubeFace::Left)
-         {
-            return eFaceCornerPos::BottomLeft;
-         }
-         else if(sideFace2 == eCubeFace::Right)
-         {
-            return eFaceCornerPos::BottomRight;
-         }
-      }
-      else if (sideFace1 == eCubeFace::Back)
-      {
-         if (sideFace2 == eCubeFace::Left)
-         {
-            return eFaceCornerPos::BottomRight;
-         }
-         else if(sideFace2 == eCubeFace::Right)
-         {
-            return eFaceCornerPos::BottomLeft;
-         }
-      }
-      else if (sideFace1 == eCubeFace::Left)
-      {
-         if (sideFace2 == eCubeFace::Front)
-         {
-            return eFaceCornerPos::BottomRight;
-         }
-         else if(sideFace2 == eCubeFace::Back)
-         {
-            return eFaceCornerPos::BottomLeft;
-         }
-      }
-      else if (sideFace1 == eCubeFace::Right)
-      {
-         if (sideFace2 == eCubeFace::Front)
-         {
-            return eFaceCornerPos::BottomLeft;
-         }
-         else if(sideFace2 == eCubeFace::Back)
-         {
-            return eFaceCornerPos::BottomRight;
-         }
-      }
-
-      // Invalid case.
-      assert(false);
-      return eFaceCornerPos::TopLeft;
-   }
-
-   static eFaceEdgePos GetF2lEdgePair(Cube& cube, eCubeFace sideFace1, eCubeFace sideFace2)
-   {
-      assert(sideFace1 != eCubeFace::Top && sideFace1 != eCubeFace::Bottom);
-      assert(sideFace2 != eCubeFace::Top && sideFace2 != eCubeFace::Bottom);
-      assert(sideFace1 != sideFace2);
-      assert(GetOppositeFace(sideFace1) != sideFace2);
-
-      if (sideFace1 == eCubeFace::Front)
-      {
-         if (sideFace2 == eCubeFace::Left)
-         {
-            return eFaceEdgePos::LeftEdge;
-         }
-         else if(sideFace2 == eCubeFace::Right)
-         {
-            return eFaceEdgePos::RightEdge;
-         }
-      }
-      else if (sideFace1 == eCubeFace::Back)
-      {
-         if (sideFace2 == eCubeFace::Left)
-         {
-            return eFaceEdgePos::RightEdge;
-         }
-         else if(sideFace2 == eCubeFace::Right)
-         {
-            return eFaceEdgePos::LeftEdge;
-         }
-      }
-      else if (sideFace1 == eCubeFace::Left)
-      {
-         if (sideFace2 == eCubeFace::Front)
-         {
-            return eFaceEdgePos::RightEdge;
-         }
-         else if(sideFace2 == eCubeFace::Back)
-         {
-            return eFaceEdgePos::LeftEdge;
-         }
-      }
-      else if (sideFace1 == eCubeFace::Right)
-      {
-         if (sideFace2 == eCubeFace::Front)
-         {
-            return eFaceEdgePos::LeftEdge;
-         }
-         else if(sideFace2 == eCubeFace::Back)
-         {
-            return eFaceEdgePos::RightEdge;
-         }
-      }
-
-      // Invalid case.
-      assert(false);
-      return eFaceEdgePos::TopEdge;
-   }
-
    static bool IsF2lPairSolved(Cube& cube, eCubeFace sideFace1, eCubeFace sideFace2)
    {
-      eCubeAxis sideFace1Axis = CubeSolveUtils::GetAxisForFace(sideFace1);
-      eCubeAxis sideFace2Axis = CubeSolveUtils::GetAxisForFace(sideFace2);
-
-      assert(sideFace1Axis == eCubeAxis::XAxis || sideFace1Axis == eCubeAxis::ZAxis);
-      assert(sideFace2Axis == eCubeAxis::XAxis || sideFace2Axis == eCubeAxis::ZAxis);
-      assert(sideFace1Axis != sideFace2Axis);
-
-      eCubeColor face1Color = cube.ColorOfFace(sideFace1);
-      eCubeColor face2Color = cube.ColorOfFace(sideFace2);
-      eFaceCornerPos f2lCorner = GetF2lPairCorner(cube, sideFace1, sideFace2);
-      eFaceEdgePos f2lEdge = GetF2lEdgePair(cube, sideFace1, sideFace2);
-
-      bool isEdgeInverted;
-      bool isEdgeInPosition = CubeSolveUtils::IsEdgeInPosition(cube, sideFace1, f2lEdge, face1Color, face2Color, isEdgeInverted);
-
-      // Check to see if both the edge and corner are in the correct positions.
-      if (!isEdgeInverted && isEdgeInPosition)
-      {
-         eCubeColor yColor, xColor, zColor;
-         CubeSolveUtils::GetCornerColors(cube, sideFace1, f2lCorner, yColor, xColor, zColor);
-
-         if (yColor == BottomColor)
-         {
-            if (sideFace1Axis == eCubeAxis::XAxis)
-            {
-               return xColor == face1Color && zColor == face2Color;
-            }
-            else if (sideFace1Axis == eCubeAxis::ZAxis)
-            {
-               return zColor == face1Color && xColor == face2Color;
-            }
-         }
-      }
-
-      return false;
+      return StickerPredicate::F2lPair(sideFace1, sideFace2).Matches(cube);
    }
 
    /**
@@ -2367,7 +2161,7 @@ namespace cube
       if (moveList.GetNumMoves() > 0)
       {
          outputStream << "F2L: ";
-         moveList.SerializeMoves(outputStream);
+         moveList.SerializeMoves(outputStream, addSeparators);
          outputStream << "\n";
          return true;
       }
@@ -2382,13 +2176,7 @@ namespace cube
 
    static void EnsureOLLSolved(Cube& cube)
    {
-      for (int i = 0; i < CubeSize; i++)
-      {
-         for (int j = 0; j < CubeSize; j++)
-         {
-            assert(cube.GetState(eCubeFace::Top, i, j) == cube.ColorOfFace(eCubeFace::Top));
-         }
-      }
+      assert(StickerPredicate::FaceSolved(eCubeFace::Top).Matches(cube) && "OLL not solved.");
    }
 
    static bool SolveOrientLastLayer(Cube& cube, std::ostream& outputStream, bool addSeparators)
@@ -2402,7 +2190,7 @@ namespace cube
       if (moveList.GetNumMoves() > 0)
       {
          outputStream << "OLL: ";
-         moveList.SerializeMoves(outputStream);
+         moveList.SerializeMoves(outputStream, addSeparators);
          outputStream << "\n";
          return true;
       }
@@ -2454,7 +2242,7 @@ namespace cube
       if (moveList.GetNumMoves() > 0)
       {
          outputStream << "PLL: ";
-         moveList.SerializeMoves(outputStream);
+         moveList.SerializeMoves(outputStream, addSeparators);
          outputStream << "\n";
          return true;
       }
@@ -2467,6 +2255,21 @@ namespace cube
 
    void CfopSolver::Solve(std::ostream& outputStream)
    {
+      // Don't spend any time on states that can't be solved.
+      if (!mCube.Validate())
+      {
+         outputStream << "Invalid cube state, can't be solved.\n";
+         return;
+      }
+
+      // The solver rotates the cube constantly, only track the orientation while solving.
+      bool virtualRotations = mCube.GetVirtualRotations();
+      mCube.SetVirtualRotations(true);
+
+      // Piece searches are lookups instead of sticker scans while the index is kept.
+      bool pieceTracking = mCube.GetPieceTracking();
+      mCube.SetPieceTracking(true);
+
       if (OrientCube(mCube, outputStream, mAddSeparators) && mShowCubeAfterEachStep)
       {
          mCube.Print(outputStream);
@@ -2491,5 +2294,8 @@ namespace cube
       {
          mCube.Print(outputStream);
       }
+
+      mCube.SetVirtualRotations(virtualRotations);
+      mCube.SetPieceTracking(pieceTracking);
    }
 }
\ No newline at end of file
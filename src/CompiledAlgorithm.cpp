@@ -0,0 +1,95 @@
+#include "CompiledAlgorithm.hpp"
+
+namespace cube
+{
+constexpr int FaceStickers = CubeSize * CubeSize;
+
+CompiledAlgorithm::CompiledAlgorithm()
+{
+   for (int slot = 0; slot < NumStickerSlots; slot++)
+   {
+      mSourceSlots[slot] = static_cast<uint8_t>(slot);
+   }
+
+   Compile();
+}
+
+CompiledAlgorithm::CompiledAlgorithm(const std::vector<eCubeMove>& moves)
+   : CompiledAlgorithm(moves.data(), moves.size())
+{
+}
+
+CompiledAlgorithm::CompiledAlgorithm(const eCubeMove* moves, size_t numMoves, bool recordMoves)
+{
+   if (recordMoves)
+   {
+      mMoves.assign(moves, moves + numMoves);
+   }
+
+   // Run the moves on a cube where every sticker holds its own slot instead of a color, the result
+   // says where each sticker came from.
+   CubeFaceData labels;
+   for (int slot = 0; slot < NumStickerSlots; slot++)
+   {
+      labels[slot / FaceStride][slot % FaceStride] = static_cast<eCubeColor>(slot);
+   }
+
+   Cube labeledCube;
+   labeledCube.SetFaceData(labels);
+   labeledCube.ExecuteMoves(moves, numMoves);
+
+   for (int slot = 0; slot < NumStickerSlots; slot++)
+   {
+      int face = slot / FaceStride;
+      int idx = slot % FaceStride;
+      mSourceSlots[slot] = idx < FaceStickers
+                              ? static_cast<uint8_t>(labeledCube.GetFaceData()[face][idx])
+                              : static_cast<uint8_t>(slot);
+   }
+
+   Compile();
+}
+
+void CompiledAlgorithm::Append(const CompiledAlgorithm& other)
+{
+   std::array<uint8_t, NumStickerSlots> sourceSlots;
+   for (int slot = 0; slot < NumStickerSlots; slot++)
+   {
+      sourceSlots[slot] = mSourceSlots[other.mSourceSlots[slot]];
+   }
+
+   mSourceSlots = sourceSlots;
+   mMoves.insert(mMoves.end(), other.mMoves.begin(), other.mMoves.end());
+   Compile();
+}
+
+CompiledAlgorithm CompiledAlgorithm::Inverse() const
+{
+   CompiledAlgorithm result;
+   for (int slot = 0; slot < NumStickerSlots; slot++)
+   {
+      result.mSourceSlots[mSourceSlots[slot]] = static_cast<uint8_t>(slot);
+   }
+
+   Cube::ReverseMoves(mMoves, result.mMoves);
+   result.Compile();
+   return result;
+}
+
+void CompiledAlgorithm::Compile()
+{
+   for (int slot = 0; slot < NumStickerSlots; slot++)
+   {
+      mDestinationSlots[mSourceSlots[slot]] = static_cast<uint8_t>(slot);
+   }
+
+   CubeFaceData labeledResult;
+   for (int slot = 0; slot < NumStickerSlots; slot++)
+   {
+      labeledResult[slot / FaceStride][slot % FaceStride] =
+         static_cast<eCubeColor>(mSourceSlots[slot]);
+   }
+
+   mShuffle = BuildPermutationShuffle(labeledResult);
+}
+}   // namespace cube
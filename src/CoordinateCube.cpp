@@ -0,0 +1,405 @@
+#include "CoordinateCube.hpp"
+#include "CubeMoves.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <thread>
+#include <vector>
+
+namespace cube
+{
+constexpr int NumSliceEdges = 4;
+constexpr int FirstSliceEdge = EnumToInt(eEdge::FR);
+
+/**
+ * @brief      The binomial coefficient n choose k, 0 when k > n.
+ */
+[[nodiscard]] static constexpr int Choose(int n, int k)
+{
+   if (k < 0 || k > n)
+   {
+      return 0;
+   }
+
+   int result = 1;
+   for (int i = 0; i < k; i++)
+   {
+      result = result * (n - i) / (i + 1);
+   }
+
+   return result;
+}
+
+/**
+ * @brief      Ranks a permutation of 0 to N - 1 by its Lehmer code, the identity is 0.
+ */
+template <size_t N>
+[[nodiscard]] static uint32_t RankPermutation(const std::array<uint8_t, N>& permutation)
+{
+   uint32_t rank = 0;
+   uint32_t seen = 0;
+   for (size_t i = 0; i < N; i++)
+   {
+      // Elements to the right that are smaller, that is not seen yet on the left.
+      uint32_t below = (1u << permutation[i]) - 1;
+      int smallerRight = permutation[i] - std::popcount(seen & below);
+      rank = rank * static_cast<uint32_t>(N - i) + static_cast<uint32_t>(smallerRight);
+      seen |= 1u << permutation[i];
+   }
+
+   return rank;
+}
+
+/**
+ * @brief      The inverse of RankPermutation.
+ */
+template <size_t N>
+static void UnrankPermutation(uint32_t rank, std::array<uint8_t, N>& permutation)
+{
+   std::array<uint8_t, N> digits;
+   for (size_t i = N; i-- > 0;)
+   {
+      digits[i] = static_cast<uint8_t>(rank % (N - i));
+      rank /= static_cast<uint32_t>(N - i);
+   }
+
+   uint32_t used = 0;
+   for (size_t i = 0; i < N; i++)
+   {
+      // The digit-th smallest element not used yet.
+      int remaining = digits[i];
+      uint8_t element = 0;
+      for (;; element++)
+      {
+         if ((used >> element) & 1)
+         {
+            continue;
+         }
+
+         if (remaining-- == 0)
+         {
+            break;
+         }
+      }
+
+      permutation[i] = element;
+      used |= 1u << element;
+   }
+}
+
+CoordinateCube::CoordinateCube()
+   : mCornerTwist(0), mEdgeFlip(0), mUDSlice(0), mCornerPermutation(0)
+{
+   PrepareMoveTables();
+}
+
+CoordinateCube::CoordinateCube(const CubieCube& cubieCube)
+   : mCornerTwist(static_cast<uint16_t>(GetCornerTwist(cubieCube))),
+     mEdgeFlip(static_cast<uint16_t>(GetEdgeFlip(cubieCube))),
+     mUDSlice(static_cast<uint16_t>(GetUDSlice(cubieCube))),
+     mCornerPermutation(static_cast<uint16_t>(GetCornerPermutation(cubieCube)))
+{
+   PrepareMoveTables();
+}
+
+CoordinateCube::CoordinateCube(const Cube& cube) : CoordinateCube(CubieCube(cube))
+{
+}
+
+int CoordinateCube::GetCornerTwist(const CubieCube& cubieCube)
+{
+   int twist = 0;
+   for (int i = 0; i < NumCorners - 1; i++)
+   {
+      twist = twist * 3 + cubieCube.GetCornerTwist(static_cast<eCorner>(i));
+   }
+
+   return twist;
+}
+
+void CoordinateCube::SetCornerTwist(CubieCube& cubieCube, int twist)
+{
+   assert(twist >= 0 && twist < NumCornerTwists && "Invalid corner twist coordinate.");
+
+   int twistSum = 0;
+   for (int i = NumCorners - 2; i >= 0; i--)
+   {
+      eCorner slot = static_cast<eCorner>(i);
+      cubieCube.SetCorner(slot, cubieCube.GetCorner(slot), twist % 3);
+      twistSum += twist % 3;
+      twist /= 3;
+   }
+
+   eCorner last = static_cast<eCorner>(NumCorners - 1);
+   cubieCube.SetCorner(last, cubieCube.GetCorner(last), (3 - twistSum % 3) % 3);
+}
+
+int CoordinateCube::GetEdgeFlip(const CubieCube& cubieCube)
+{
+   int flip = 0;
+   for (int i = 0; i < NumEdges - 1; i++)
+   {
+      flip = flip * 2 + cubieCube.GetEdgeFlip(static_cast<eEdge>(i));
+   }
+
+   return flip;
+}
+
+void CoordinateCube::SetEdgeFlip(CubieCube& cubieCube, int flip)
+{
+   assert(flip >= 0 && flip < NumEdgeFlips && "Invalid edge flip coordinate.");
+
+   int flipSum = 0;
+   for (int i = NumEdges - 2; i >= 0; i--)
+   {
+      eEdge slot = static_cast<eEdge>(i);
+      cubieCube.SetEdge(slot, cubieCube.GetEdge(slot), flip & 1);
+      flipSum += flip & 1;
+      flip >>= 1;
+   }
+
+   eEdge last = static_cast<eEdge>(NumEdges - 1);
+   cubieCube.SetEdge(last, cubieCube.GetEdge(last), flipSum & 1);
+}
+
+int CoordinateCube::GetUDSlice(const CubieCube& cubieCube)
+{
+   // Combinatorial number system over the slots counted from BR, so the solved cube is 0.
+   int slice = 0;
+   int found = 0;
+   for (int i = NumEdges - 1; i >= 0; i--)
+   {
+      if (EnumToInt(cubieCube.GetEdge(static_cast<eEdge>(i))) >= FirstSliceEdge)
+      {
+         found++;
+         slice += Choose(NumEdges - 1 - i, found);
+      }
+   }
+
+   return slice;
+}
+
+void CoordinateCube::SetUDSlice(CubieCube& cubieCube, int slice)
+{
+   assert(slice >= 0 && slice < NumUDSlices && "Invalid UD slice coordinate.");
+
+   std::array<bool, NumEdges> isSliceSlot = {};
+   for (int k = NumSliceEdges; k > 0; k--)
+   {
+      int position = k - 1;
+      while (Choose(position + 1, k) <= slice)
+      {
+         position++;
+      }
+
+      slice -= Choose(position, k);
+      isSliceSlot[NumEdges - 1 - position] = true;
+   }
+
+   int nextSliceEdge = FirstSliceEdge;
+   int nextOtherEdge = 0;
+   for (int i = 0; i < NumEdges; i++)
+   {
+      eEdge slot = static_cast<eEdge>(i);
+      int piece = isSliceSlot[i] ? nextSliceEdge++ : nextOtherEdge++;
+      cubieCube.SetEdge(slot, static_cast<eEdge>(piece), cubieCube.GetEdgeFlip(slot));
+   }
+}
+
+int CoordinateCube::GetCornerPermutation(const CubieCube& cubieCube)
+{
+   std::array<uint8_t, NumCorners> permutation;
+   for (int i = 0; i < NumCorners; i++)
+   {
+      permutation[i] = static_cast<uint8_t>(cubieCube.GetCorner(static_cast<eCorner>(i)));
+   }
+
+   return static_cast<int>(RankPermutation(permutation));
+}
+
+void CoordinateCube::SetCornerPermutation(CubieCube& cubieCube, int permutation)
+{
+   assert(permutation >= 0 && permutation < NumCornerPermutations &&
+          "Invalid corner permutation coordinate.");
+
+   std::array<uint8_t, NumCorners> pieces;
+   UnrankPermutation(static_cast<uint32_t>(permutation), pieces);
+   for (int i = 0; i < NumCorners; i++)
+   {
+      eCorner slot = static_cast<eCorner>(i);
+      cubieCube.SetCorner(slot, static_cast<eCorner>(pieces[i]), cubieCube.GetCornerTwist(slot));
+   }
+}
+
+uint32_t CoordinateCube::GetEdgePermutation(const CubieCube& cubieCube)
+{
+   std::array<uint8_t, NumEdges> permutation;
+   for (int i = 0; i < NumEdges; i++)
+   {
+      permutation[i] = static_cast<uint8_t>(cubieCube.GetEdge(static_cast<eEdge>(i)));
+   }
+
+   return RankPermutation(permutation);
+}
+
+void CoordinateCube::SetEdgePermutation(CubieCube& cubieCube, uint32_t permutation)
+{
+   assert(permutation < NumEdgePermutations && "Invalid edge permutation coordinate.");
+
+   std::array<uint8_t, NumEdges> pieces;
+   UnrankPermutation(permutation, pieces);
+   for (int i = 0; i < NumEdges; i++)
+   {
+      eEdge slot = static_cast<eEdge>(i);
+      cubieCube.SetEdge(slot, static_cast<eEdge>(pieces[i]), cubieCube.GetEdgeFlip(slot));
+   }
+}
+
+/**
+ * @brief      The value of every coordinate after every move, indexed by
+ * coordinate * NumMoves + move so the moves of one value share cache lines.
+ */
+struct tCoordinateMoveTables
+{
+   std::vector<uint16_t> CornerTwist;
+   std::vector<uint16_t> EdgeFlip;
+   std::vector<uint16_t> UDSlice;
+   std::vector<uint16_t> CornerPermutation;
+};
+
+/**
+ * @brief      Builds the move table of one coordinate. Only the clockwise move of every family
+ * goes through the cubie model, its prime and double are that move applied 3 and 2 times. The
+ * values are split between threads for the larger coordinates.
+ */
+template <typename GetFunc, typename SetFunc>
+static std::vector<uint16_t> BuildMoveTable(int numValues, GetFunc get, SetFunc set)
+{
+   // Below this, starting threads costs more than filling the table.
+   constexpr int minValuesPerThread = 4096;
+
+   std::vector<uint16_t> table(static_cast<size_t>(numValues) * NumMoves);
+   auto fillClockwiseMoves = [&table, get, set](int begin, int end)
+   {
+      for (int value = begin; value < end; value++)
+      {
+         CubieCube cubieCube;
+         set(cubieCube, value);
+
+         for (int move = 0; move < NumMoves; move += 3)
+         {
+            CubieCube moved = cubieCube;
+            moved.Multiply(CubieCube::GetMoveCube(static_cast<eCubeMove>(move)));
+            table[value * NumMoves + move] = static_cast<uint16_t>(get(moved));
+         }
+      }
+   };
+
+   int numChunks = std::min<int>(std::max(std::thread::hardware_concurrency(), 1u),
+      numValues / minValuesPerThread);
+   if (numChunks <= 1)
+   {
+      fillClockwiseMoves(0, numValues);
+   }
+   else
+   {
+      std::vector<std::thread> threads;
+      threads.reserve(numChunks);
+
+      int chunkSize = numValues / numChunks;
+      for (int i = 0; i < numChunks; i++)
+      {
+         int begin = i * chunkSize;
+         int end = i == numChunks - 1 ? numValues : begin + chunkSize;
+         threads.emplace_back(fillClockwiseMoves, begin, end);
+      }
+
+      for (auto& thread : threads)
+      {
+         thread.join();
+      }
+   }
+
+   for (int value = 0; value < numValues; value++)
+   {
+      for (int move = 0; move < NumMoves; move += 3)
+      {
+         uint16_t once = table[value * NumMoves + move];
+         uint16_t twice = table[once * NumMoves + move];
+         table[value * NumMoves + move + 1] = table[twice * NumMoves + move];
+         table[value * NumMoves + move + 2] = twice;
+      }
+   }
+
+   return table;
+}
+
+// Set once the tables are built. Every constructor builds them first, so ExecuteMove reads this
+// instead of going through the initialization guard of GetMoveTables on every move.
+static const tCoordinateMoveTables* sMoveTables = nullptr;
+
+static const tCoordinateMoveTables& GetMoveTables()
+{
+   static const tCoordinateMoveTables tables = []()
+   {
+      tCoordinateMoveTables result;
+      result.CornerTwist = BuildMoveTable(NumCornerTwists,
+         [](const CubieCube& cubieCube) { return CoordinateCube::GetCornerTwist(cubieCube); },
+         [](CubieCube& cubieCube, int value) { CoordinateCube::SetCornerTwist(cubieCube, value); });
+      result.EdgeFlip = BuildMoveTable(NumEdgeFlips,
+         [](const CubieCube& cubieCube) { return CoordinateCube::GetEdgeFlip(cubieCube); },
+         [](CubieCube& cubieCube, int value) { CoordinateCube::SetEdgeFlip(cubieCube, value); });
+      result.UDSlice = BuildMoveTable(NumUDSlices,
+         [](const CubieCube& cubieCube) { return CoordinateCube::GetUDSlice(cubieCube); },
+         [](CubieCube& cubieCube, int value) { CoordinateCube::SetUDSlice(cubieCube, value); });
+      result.CornerPermutation = BuildMoveTable(NumCornerPermutations,
+         [](const CubieCube& cubieCube) { return CoordinateCube::GetCornerPermutation(cubieCube); },
+         [](CubieCube& cubieCube, int value)
+         { CoordinateCube::SetCornerPermutation(cubieCube, value); });
+      return result;
+   }();
+
+   // Published from inside the guarded initialization, so threads that went through the guard see
+   // the pointer set.
+   [[maybe_unused]] static const bool isPublished = []()
+   {
+      sMoveTables = &tables;
+      return true;
+   }();
+
+   return tables;
+}
+
+void CoordinateCube::PrepareMoveTables()
+{
+   GetMoveTables();
+}
+
+bool CoordinateCube::AreCoordinatesSolved() const
+{
+   return mCornerTwist == 0 && mEdgeFlip == 0 && mUDSlice == 0 && mCornerPermutation == 0;
+}
+
+void CoordinateCube::ExecuteMove(eCubeMove move)
+{
+   assert(EnumToInt(move) < NumMoves && "Invalid move");
+
+   assert(sMoveTables && "The move tables are built by the constructors.");
+   const tCoordinateMoveTables& tables = *sMoveTables;
+   int moveIdx = EnumToInt(move);
+   mCornerTwist = tables.CornerTwist[mCornerTwist * NumMoves + moveIdx];
+   mEdgeFlip = tables.EdgeFlip[mEdgeFlip * NumMoves + moveIdx];
+   mUDSlice = tables.UDSlice[mUDSlice * NumMoves + moveIdx];
+   mCornerPermutation = tables.CornerPermutation[mCornerPermutation * NumMoves + moveIdx];
+}
+
+void CoordinateCube::ExecuteMoves(const eCubeMove* moves, size_t numMoves)
+{
+   for (size_t i = 0; i < numMoves; i++)
+   {
+      ExecuteMove(moves[i]);
+   }
+}
+}   // namespace cube
@@ -1,888 +1,1383 @@
 #include "Cube.hpp"
-
+#include "CompiledAlgorithm.hpp"
+#include "CubeGeometry.hpp"
+#include "CubeMoves.hpp"
+#include "CubeMoveEngine.hpp"
+#include "CubePredicates.hpp"
+#include "CubieCube.hpp"
+#include "MoveNotation.hpp"
+
+#include <algorithm>
 #include <array>
+#include <cstring>
 #include <iostream>
-#include <map>
 #include <ostream>
+#include <random>
 #include <string>
-#include <unordered_set>
+#include <thread>
 #include <utility>
 
 namespace cube
 {
-[[nodiscard]] constexpr int InvertLayer(int layer)
+constexpr int NumFaces = EnumToInt(eCubeFace::NumFaces);
+constexpr int FaceStickers = CubeSize * CubeSize;
+constexpr int NumStickers = NumFaces * FaceStickers;
+
+/**
+ * @brief      Describes a move as a turn of some layers around an axis. Quarter turns are counter
+ * clockwise when looking at the axis from its positive end (right hand rule), so R is 3 quarter
+ * turns around X while L is 1.
+ */
+struct tMoveDescriptor
+{
+   eCubeAxis Axis;
+   // See NegativeLayer, MiddleLayer and PositiveLayer.
+   uint8_t LayerMask;
+   uint8_t QuarterTurns;
+};
+
+[[nodiscard]] static constexpr tMoveDescriptor GetMoveDescriptor(eCubeMove move)
 {
-   return CubeSize - layer - 1;
+   const tMoveInfo& info = GetMoveInfo(move);
+   return { info.Axis, info.LayerMask, info.QuarterTurns };
 }
 
-enum Coord
-{
-   TopLeftCorner,
-   TopEdge,
-   TopRightCorner,
-   LeftEdge,
-   Middle,
-   RightEdge,
-   BottomLeftCorner,
-   BottomEdge,
-   BottomRightCorner,
-   NumCoords
+/**
+ * @brief      The stickers changed by one move. Dst[i] receives what was in Src[i] before the
+ * move. Slots are face * FaceStride + index within the face.
+ */
+struct tMoveKernel
+{
+   std::array<uint8_t, NumStickers> Dst;
+   std::array<uint8_t, NumStickers> Src;
+   uint8_t NumChanged;
 };
 
-static void RotateFaceClockwise(CubeFaceData& faceData, eCubeFace face)
-{
-   SingleCubeFace& faceToRotate = faceData[EnumToInt(face)];
-
-   eCubeColor topLeftCorner = faceToRotate[TopLeftCorner];
-   eCubeColor topEdge = faceToRotate[TopEdge];
-   eCubeColor topRightCorner = faceToRotate[TopRightCorner];
-   eCubeColor leftEdge = faceToRotate[LeftEdge];
-   eCubeColor rightEdge = faceToRotate[RightEdge];
-   eCubeColor bottomLeftCorner = faceToRotate[BottomLeftCorner];
-   eCubeColor bottomEdge = faceToRotate[BottomEdge];
-   eCubeColor bottomRightCorner = faceToRotate[BottomRightCorner];
-
-   faceToRotate[TopLeftCorner] = bottomLeftCorner;
-   faceToRotate[TopEdge] = leftEdge;
-   faceToRotate[TopRightCorner] = topLeftCorner;
-   faceToRotate[LeftEdge] = bottomEdge;
-   faceToRotate[RightEdge] = topEdge;
-   faceToRotate[BottomLeftCorner] = bottomRightCorner;
-   faceToRotate[BottomEdge] = rightEdge;
-   faceToRotate[BottomRightCorner] = topRightCorner;
-}
-
-static void RotateFaceCounterClockwise(CubeFaceData& faceData, eCubeFace face)
+[[nodiscard]] static constexpr tMoveKernel GenerateMoveKernel(eCubeMove move)
 {
+   tMoveDescriptor descriptor = GetMoveDescriptor(move);
+   tMoveKernel kernel = {};
 
-   SingleCubeFace& faceToRotate = faceData[EnumToInt(face)];
+   for (int sticker = 0; sticker < NumStickers; sticker++)
+   {
+      tStickerGeometry geometry = GetStickerGeometry(sticker);
+      if ((descriptor.LayerMask & (1 << (geometry.Position.Along(descriptor.Axis) + 1))) == 0)
+      {
+         continue;
+      }
 
-   eCubeColor topLeftCorner = faceToRotate[TopLeftCorner];
-   eCubeColor topEdge = faceToRotate[TopEdge];
-   eCubeColor topRightCorner = faceToRotate[TopRightCorner];
-   eCubeColor leftEdge = faceToRotate[LeftEdge];
-   eCubeColor rightEdge = faceToRotate[RightEdge];
-   eCubeColor bottomLeftCorner = faceToRotate[BottomLeftCorner];
-   eCubeColor bottomEdge = faceToRotate[BottomEdge];
-   eCubeColor bottomRightCorner = faceToRotate[BottomRightCorner];
+      for (int i = 0; i < descriptor.QuarterTurns; i++)
+      {
+         geometry.Position = geometry.Position.RotateQuarter(descriptor.Axis);
+         geometry.Normal = geometry.Normal.RotateQuarter(descriptor.Axis);
+      }
 
-   faceToRotate[TopLeftCorner] = topRightCorner;
-   faceToRotate[TopEdge] = rightEdge;
-   faceToRotate[TopRightCorner] = bottomRightCorner;
-   faceToRotate[LeftEdge] = topEdge;
-   faceToRotate[RightEdge] = bottomEdge;
-   faceToRotate[BottomLeftCorner] = topLeftCorner;
-   faceToRotate[BottomEdge] = leftEdge;
-   faceToRotate[BottomRightCorner] = bottomLeftCorner;
-}
+      int dst = FindSticker(geometry);
+      if (dst != sticker)
+      {
+         kernel.Dst[kernel.NumChanged] =
+            static_cast<uint8_t>(dst / FaceStickers * FaceStride + dst % FaceStickers);
+         kernel.Src[kernel.NumChanged] =
+            static_cast<uint8_t>(sticker / FaceStickers * FaceStride + sticker % FaceStickers);
+         kernel.NumChanged++;
+      }
+   }
 
-static void RotateFaceTwice(CubeFaceData& faceData, eCubeFace face)
-{
-   SingleCubeFace& faceToRotate = faceData[EnumToInt(face)];
-
-   eCubeColor topLeftCorner = faceToRotate[TopLeftCorner];
-   eCubeColor topEdge = faceToRotate[TopEdge];
-   eCubeColor topRightCorner = faceToRotate[TopRightCorner];
-   eCubeColor leftEdge = faceToRotate[LeftEdge];
-   eCubeColor rightEdge = faceToRotate[RightEdge];
-   eCubeColor bottomLeftCorner = faceToRotate[BottomLeftCorner];
-   eCubeColor bottomEdge = faceToRotate[BottomEdge];
-   eCubeColor bottomRightCorner = faceToRotate[BottomRightCorner];
-
-   faceToRotate[TopLeftCorner] = bottomRightCorner;
-   faceToRotate[TopEdge] = bottomEdge;
-   faceToRotate[TopRightCorner] = bottomLeftCorner;
-   faceToRotate[LeftEdge] = rightEdge;
-   faceToRotate[RightEdge] = leftEdge;
-   faceToRotate[BottomLeftCorner] = topRightCorner;
-   faceToRotate[BottomEdge] = topEdge;
-   faceToRotate[BottomRightCorner] = topLeftCorner;
+   return kernel;
 }
 
-template <int TLayer>
-static void GetRowData(SingleCubeFace& face, eCubeColor& first, eCubeColor& second, eCubeColor& third)
-{
-   first = face[CubeDimsToIdx(0, TLayer)];
-   second = face[CubeDimsToIdx(1, TLayer)];
-   third = face[CubeDimsToIdx(2, TLayer)];
-}
+using MoveKernels = std::array<tMoveKernel, EnumToInt(eCubeMove::NumMoves)>;
 
-template <int TLayer, bool TReverse>
-static void SetRowData(SingleCubeFace& face, eCubeColor first, eCubeColor second, eCubeColor third)
+static constexpr MoveKernels GeneratedMoveKernels = []()
 {
-   if constexpr (TReverse)
-   {
-      face[CubeDimsToIdx(0, TLayer)] = third;
-      face[CubeDimsToIdx(1, TLayer)] = second;
-      face[CubeDimsToIdx(2, TLayer)] = first; 
-   }
-   else
+   MoveKernels result = {};
+   for (int i = 0; i < EnumToInt(eCubeMove::NumMoves); i++)
    {
-      face[CubeDimsToIdx(0, TLayer)] = first;
-      face[CubeDimsToIdx(1, TLayer)] = second;
-      face[CubeDimsToIdx(2, TLayer)] = third; 
+      result[i] = GenerateMoveKernel(static_cast<eCubeMove>(i));
    }
+
+   return result;
+}();
+
+static_assert(GeneratedMoveKernels[EnumToInt(eCubeMove::Up)].NumChanged == 20,
+   "A face turn moves 20 stickers.");
+static_assert(GeneratedMoveKernels[EnumToInt(eCubeMove::Middle2)].NumChanged == 12,
+   "A slice turn moves 12 stickers.");
+static_assert(GeneratedMoveKernels[EnumToInt(eCubeMove::X)].NumChanged == 52,
+   "A rotation moves everything but 2 centers.");
+
+/**
+ * @brief      Executes a generated kernel. Everything about the kernel is known at compile time, so
+ * this expands to straight line byte copies just like a hand written move.
+ */
+template <int TMove, size_t... TIdx>
+static void ExecuteKernel(CubeFaceData& cube, std::index_sequence<TIdx...>)
+{
+   constexpr const tMoveKernel& kernel = GeneratedMoveKernels[TMove];
+
+   // Gather everything that moves before scattering, the sources overlap the destinations.
+   const std::array<eCubeColor, sizeof...(TIdx)> moved = {
+      cube[kernel.Src[TIdx] / FaceStride][kernel.Src[TIdx] % FaceStride]...
+   };
+   ((cube[kernel.Dst[TIdx] / FaceStride][kernel.Dst[TIdx] % FaceStride] = moved[TIdx]), ...);
 }
 
-template <int TLayer>
-struct tLayerRotateYData
+template <int TMove>
+static void ExecuteGeneratedMove(CubeFaceData& cube)
 {
-   // Load the necessary data for our operations.
-   tLayerRotateYData(CubeFaceData& faceData)
-   : FrontFace(faceData[EnumToInt(eCubeFace::Front)]),
-     LeftFace(faceData[EnumToInt(eCubeFace::Left)]),
-     BackFace(faceData[EnumToInt(eCubeFace::Back)]),
-     RightFace(faceData[EnumToInt(eCubeFace::Right)])
-   {
-      GetRowData<TLayer>(FrontFace, FrontLeft, FrontMiddle, FrontRight);
-      GetRowData<TLayer>(LeftFace, LeftLeft, LeftMiddle, LeftRight);
-      GetRowData<TLayer>(BackFace, BackLeft, BackMiddle, BackRight);
-      GetRowData<TLayer>(RightFace, RightLeft, RightMiddle, RightRight);
-   }
+   ExecuteKernel<TMove>(cube, std::make_index_sequence<GeneratedMoveKernels[TMove].NumChanged>());
+}
 
-   SingleCubeFace &FrontFace, &LeftFace, &BackFace, &RightFace;
+using MoveFunction = void (*)(CubeFaceData&);
 
-   eCubeColor FrontLeft, FrontMiddle, FrontRight;
-   eCubeColor LeftLeft, LeftMiddle, LeftRight;
-   eCubeColor BackLeft, BackMiddle, BackRight;
-   eCubeColor RightLeft, RightMiddle, RightRight;
-};
+template <size_t... TMoves>
+static constexpr std::array<MoveFunction, sizeof...(TMoves)> CreateMoveFunctions(
+   std::index_sequence<TMoves...>)
+{
+   return { &ExecuteGeneratedMove<TMoves>... };
+}
+
+/**
+ * @brief      Flat dispatch table for the scalar engine, indexed by eCubeMove.
+ */
+static constexpr auto MoveFunctions =
+   CreateMoveFunctions(std::make_index_sequence<EnumToInt(eCubeMove::NumMoves)>());
 
-template <int TLayer>
-static void LayerRotateYClockwise(CubeFaceData& faceData)
+Cube::Cube()
 {
-   tLayerRotateYData<TLayer> layerData(faceData);
+   static_assert(
+      EnumToInt(eCubeColor::Yellow) == EnumToInt(eCubeFace::Top), "Incorrect cube config.");
+   static_assert(
+      EnumToInt(eCubeColor::White) == EnumToInt(eCubeFace::Bottom), "Incorrect cube config.");
+   static_assert(
+      EnumToInt(eCubeColor::Red) == EnumToInt(eCubeFace::Left), "Incorrect cube config.");
+   static_assert(
+      EnumToInt(eCubeColor::Orange) == EnumToInt(eCubeFace::Right), "Incorrect cube config.");
+   static_assert(
+      EnumToInt(eCubeColor::Green) == EnumToInt(eCubeFace::Front), "Incorrect cube config.");
+   static_assert(
+      EnumToInt(eCubeColor::Blue) == EnumToInt(eCubeFace::Back), "Incorrect cube config.");
 
-   SetRowData<TLayer, false>(layerData.FrontFace, layerData.RightLeft, layerData.RightMiddle, layerData.RightRight);
-   SetRowData<TLayer, false>(layerData.LeftFace, layerData.FrontLeft, layerData.FrontMiddle, layerData.FrontRight);
-   SetRowData<TLayer, false>(layerData.BackFace, layerData.LeftLeft, layerData.LeftMiddle, layerData.LeftRight);
-   SetRowData<TLayer, false>(layerData.RightFace, layerData.BackLeft, layerData.BackMiddle, layerData.BackRight);
+   SetSolved();
 }
 
-template <int TLayer>
-static void LayerRotateYCounterClockwise(CubeFaceData& faceData)
+void Cube::SetSolved()
 {
-   tLayerRotateYData<TLayer> layerData(faceData);
+   mOrientation = 0;
+
+   for (int i = 0; i < EnumToInt(eCubeColor::NumColors); i++)
+   {
+      eCubeColor color = static_cast<eCubeColor>(i);
+      int face = EnumToInt(DefaultFaceOfColor(color));
+
+      // Only the real stickers get the color, the padding stays zero so faces compare as raw bytes.
+      mCube[face] = {};
+      for (int i = 0; i < CubeSize * CubeSize; i++)
+      {
+         mCube[face][i] = color;
+      }
+   }
 
-   SetRowData<TLayer, false>(layerData.FrontFace, layerData.LeftLeft, layerData.LeftMiddle, layerData.LeftRight);
-   SetRowData<TLayer, false>(layerData.LeftFace, layerData.BackLeft, layerData.BackMiddle, layerData.BackRight);
-   SetRowData<TLayer, false>(layerData.BackFace, layerData.RightLeft, layerData.RightMiddle, layerData.RightRight);
-   SetRowData<TLayer, false>(layerData.RightFace, layerData.FrontLeft, layerData.FrontMiddle, layerData.FrontRight);
+   if (mTrackPieces)
+   {
+      RebuildPieceIndex();
+   }
 }
 
-template <int TLayer>
-static void LayerRotateYTwice(CubeFaceData& faceData)
+bool Cube::IsSolved()
 {
-   tLayerRotateYData<TLayer> layerData(faceData);
+   // Orientation doesn't matter, every face just needs to match its own center.
+   return StickerPredicate::Solved().Matches(*this);
+}
 
-   SetRowData<TLayer, false>(layerData.FrontFace, layerData.BackLeft, layerData.BackMiddle, layerData.BackRight);
-   SetRowData<TLayer, false>(layerData.LeftFace, layerData.RightLeft, layerData.RightMiddle, layerData.RightRight);
-   SetRowData<TLayer, false>(layerData.BackFace, layerData.FrontLeft, layerData.FrontMiddle, layerData.FrontRight);
-   SetRowData<TLayer, false>(layerData.RightFace, layerData.LeftLeft, layerData.LeftMiddle, layerData.LeftRight);
+bool Cube::Validate() const
+{
+   return CheckValidity() == eCubeValidity::Valid;
 }
 
-template <int TLayer>
-static void GetColData(SingleCubeFace& face, eCubeColor& first, eCubeColor& second, eCubeColor& third)
+eCubeValidity Cube::CheckValidity() const
 {
-   first = face[CubeDimsToIdx(TLayer, 0)];
-   second = face[CubeDimsToIdx(TLayer, 1)];
-   third = face[CubeDimsToIdx(TLayer, 2)];
+   if (mOrientation == 0)
+   {
+      return CheckValidity(mCube);
+   }
+
+   CubeFaceData faceData;
+   CopyFaceData(faceData);
+   return CheckValidity(faceData);
 }
 
-template <int TLayer, bool TReverse>
-static void SetColData(SingleCubeFace& face, eCubeColor first, eCubeColor second, eCubeColor third)
+eCubeValidity Cube::CheckValidity(const CubeFaceData& faceData)
 {
-   if constexpr (TReverse)
+   // Cheap rejection first, most garbage input has the wrong number of some color.
+   std::array<uint8_t, 256> colorCounts = {};
+   for (int face = 0; face < NumFaces; face++)
    {
-      face[CubeDimsToIdx(TLayer, 0)] = third;
-      face[CubeDimsToIdx(TLayer, 1)] = second;
-      face[CubeDimsToIdx(TLayer, 2)] = first; 
+      for (int idx = 0; idx < FaceStickers; idx++)
+      {
+         colorCounts[EnumToInt(faceData[face][idx])]++;
+      }
    }
-   else
+
+   for (int color = 0; color < EnumToInt(eCubeColor::NumColors); color++)
+   {
+      if (colorCounts[color] != FaceStickers)
+      {
+         return eCubeValidity::InvalidColors;
+      }
+   }
+
+   CubieCube cubieCube;
+   if (!CubieCube::FromFaceData(faceData, cubieCube))
    {
-      face[CubeDimsToIdx(TLayer, 0)] = first;
-      face[CubeDimsToIdx(TLayer, 1)] = second;
-      face[CubeDimsToIdx(TLayer, 2)] = third; 
+      return eCubeValidity::InvalidPiece;
    }
+
+   return cubieCube.CheckValidity();
 }
 
-template <int TLayer>
-struct tLayerRotateXData
+/**
+ * @brief      A way of holding the cube, stored as the directions the X, Y and Z axes of the stored
+ * stickers point to when seen through it.
+ */
+struct tOrientation
 {
-   // Load the necessary data for our operations.
-   tLayerRotateXData(CubeFaceData& faceData)
-   : FrontFace(faceData[EnumToInt(eCubeFace::Front)]),
-     TopFace(faceData[EnumToInt(eCubeFace::Top)]),
-     BackFace(faceData[EnumToInt(eCubeFace::Back)]),
-     BottomFace(faceData[EnumToInt(eCubeFace::Bottom)])
+   tVec3 X;
+   tVec3 Y;
+   tVec3 Z;
+
+   constexpr bool operator==(const tOrientation& other) const = default;
+
+   /**
+    * @brief      Maps a direction seen through the orientation back to the stored stickers.
+    */
+   [[nodiscard]] constexpr tVec3 ToStored(const tVec3& seen) const
    {
-      GetColData<TLayer>(FrontFace, FrontTop, FrontMiddle, FrontBottom);
-      GetColData<TLayer>(TopFace, TopTop, TopMiddle, TopBottom);
-      GetColData<InvertLayer(TLayer)>(BackFace, BackTop, BackMiddle, BackBottom);
-      GetColData<TLayer>(BottomFace, BottomTop, BottomMiddle, BottomBottom);
+      return { X.Dot(seen), Y.Dot(seen), Z.Dot(seen) };
    }
 
-   SingleCubeFace &FrontFace, &TopFace, &BackFace, &BottomFace;
+   /**
+    * @brief      The orientation after turning the whole cube around the given axis.
+    */
+   [[nodiscard]] constexpr tOrientation Rotate(eCubeAxis axis, int quarterTurns) const
+   {
+      tOrientation result = *this;
+      for (int i = 0; i < quarterTurns; i++)
+      {
+         result = { result.X.RotateQuarter(axis), result.Y.RotateQuarter(axis),
+            result.Z.RotateQuarter(axis) };
+      }
 
-   eCubeColor FrontTop, FrontMiddle, FrontBottom;
-   eCubeColor TopTop, TopMiddle, TopBottom;
-   eCubeColor BackTop, BackMiddle, BackBottom;
-   eCubeColor BottomTop, BottomMiddle, BottomBottom;
+      return result;
+   }
 };
 
-template <int TLayer>
-static void LayerRotateXClockwise(CubeFaceData& faceData)
+/**
+ * @brief      Every orientation, the first one is the identity.
+ */
+static constexpr std::array<tOrientation, NumOrientations> Orientations = []()
+{
+   std::array<tOrientation, NumOrientations> result = {};
+   result[0] = { { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 } };
+
+   // Quarter turns around the three axes reach all of them.
+   int count = 1;
+   for (int i = 0; i < count; i++)
+   {
+      for (eCubeAxis axis : { eCubeAxis::XAxis, eCubeAxis::YAxis, eCubeAxis::ZAxis })
+      {
+         tOrientation candidate = result[i].Rotate(axis, 1);
+
+         bool found = false;
+         for (int j = 0; j < count; j++)
+         {
+            found = found || result[j] == candidate;
+         }
+
+         if (!found)
+         {
+            result[count++] = candidate;
+         }
+      }
+   }
+
+   return result;
+}();
+
+[[nodiscard]] static constexpr int FindOrientation(const tOrientation& orientation)
 {
-   tLayerRotateXData<TLayer> layerData(faceData);
-   SetColData<TLayer, false>(layerData.FrontFace, layerData.BottomTop, layerData.BottomMiddle, layerData.BottomBottom);
-   SetColData<TLayer, false>(layerData.TopFace, layerData.FrontTop, layerData.FrontMiddle, layerData.FrontBottom);
-   SetColData<InvertLayer(TLayer), true>(layerData.BackFace, layerData.TopTop, layerData.TopMiddle, layerData.TopBottom);
-   SetColData<TLayer, true>(layerData.BottomFace, layerData.BackTop, layerData.BackMiddle, layerData.BackBottom);
+   for (int i = 0; i < NumOrientations; i++)
+   {
+      if (Orientations[i] == orientation)
+      {
+         return i;
+      }
+   }
+
+   return -1;
 }
 
-template <int TLayer>
-static void LayerRotateXCounterClockwise(CubeFaceData& faceData)
+[[nodiscard]] static constexpr eCubeMove FindMove(const tMoveDescriptor& descriptor)
 {
-   tLayerRotateXData<TLayer> layerData(faceData);
-   SetColData<TLayer, false>(layerData.FrontFace, layerData.TopTop, layerData.TopMiddle, layerData.TopBottom);
-   SetColData<TLayer, true>(layerData.TopFace, layerData.BackTop, layerData.BackMiddle, layerData.BackBottom);
-   SetColData<InvertLayer(TLayer), true>(layerData.BackFace, layerData.BottomTop, layerData.BottomMiddle, layerData.BottomBottom);
-   SetColData<TLayer, false>(layerData.BottomFace, layerData.FrontTop, layerData.FrontMiddle, layerData.FrontBottom);
+   for (int i = 0; i < EnumToInt(eCubeMove::NumMoves); i++)
+   {
+      tMoveDescriptor candidate = GetMoveDescriptor(static_cast<eCubeMove>(i));
+      if (candidate.Axis == descriptor.Axis && candidate.LayerMask == descriptor.LayerMask &&
+          candidate.QuarterTurns == descriptor.QuarterTurns)
+      {
+         return static_cast<eCubeMove>(i);
+      }
+   }
+
+   return eCubeMove::NumMoves;
+}
+
+[[nodiscard]] static constexpr tVec3 AxisVector(eCubeAxis axis)
+{
+   return { axis == eCubeAxis::XAxis, axis == eCubeAxis::YAxis, axis == eCubeAxis::ZAxis };
 }
 
-template <int TLayer>
-static void LayerRotateXTwice(CubeFaceData& faceData)
+/**
+ * @brief      Finds the move on the stored stickers that has the same effect as the given move seen
+ * through the orientation.
+ */
+[[nodiscard]] static constexpr eCubeMove ToStoredMove(const tOrientation& orientation, eCubeMove move)
 {
-   tLayerRotateXData<TLayer> layerData(faceData);
-   SetColData<TLayer, true>(layerData.FrontFace, layerData.BackTop, layerData.BackMiddle, layerData.BackBottom);
-   SetColData<TLayer, false>(layerData.TopFace, layerData.BottomTop, layerData.BottomMiddle, layerData.BottomBottom);
-   SetColData<InvertLayer(TLayer), true>(layerData.BackFace, layerData.FrontTop, layerData.FrontMiddle, layerData.FrontBottom);
-   SetColData<TLayer, false>(layerData.BottomFace, layerData.TopTop, layerData.TopMiddle, layerData.TopBottom);
+   tMoveDescriptor descriptor = GetMoveDescriptor(move);
+   tVec3 storedAxis = orientation.ToStored(AxisVector(descriptor.Axis));
+
+   for (eCubeAxis axis : { eCubeAxis::XAxis, eCubeAxis::YAxis, eCubeAxis::ZAxis })
+   {
+      int direction = storedAxis.Dot(AxisVector(axis));
+      if (direction == 0)
+      {
+         continue;
+      }
+
+      descriptor.Axis = axis;
+      if (direction < 0)
+      {
+         // Flipping the axis mirrors the layers and reverses the turn.
+         descriptor.LayerMask = static_cast<uint8_t>(((descriptor.LayerMask & NegativeLayer) << 2) |
+            (descriptor.LayerMask & MiddleLayer) | ((descriptor.LayerMask & PositiveLayer) >> 2));
+         descriptor.QuarterTurns = static_cast<uint8_t>((4 - descriptor.QuarterTurns) % 4);
+      }
+   }
+
+   return FindMove(descriptor);
 }
 
-template <int TLayer>
-struct tLayerRotateZData
+constexpr std::array<std::array<uint8_t, NumStickers>, NumOrientations> Cube::sOrientationSlots =
+   []()
 {
-   // Load the necessary data for our operations.
-   tLayerRotateZData(CubeFaceData& faceData)
-   : TopFace(faceData[EnumToInt(eCubeFace::Top)]),
-     LeftFace(faceData[EnumToInt(eCubeFace::Left)]),
-     RightFace(faceData[EnumToInt(eCubeFace::Right)]),
-     BottomFace(faceData[EnumToInt(eCubeFace::Bottom)])
+   std::array<std::array<uint8_t, NumStickers>, NumOrientations> result = {};
+   for (int orientation = 0; orientation < NumOrientations; orientation++)
    {
-      GetRowData<InvertLayer(TLayer)>(TopFace, TopLeft, TopMiddle, TopRight);
-      GetColData<InvertLayer(TLayer)>(LeftFace, LeftTop, LeftMiddle, LeftBottom);
-      GetColData<TLayer>(RightFace, RightTop, RightMiddle, RightBottom);
-      GetRowData<TLayer>(BottomFace, BottomLeft, BottomMiddle, BottomRight);
+      for (int sticker = 0; sticker < NumStickers; sticker++)
+      {
+         tStickerGeometry geometry = GetStickerGeometry(sticker);
+         int stored = FindSticker({ Orientations[orientation].ToStored(geometry.Position),
+            Orientations[orientation].ToStored(geometry.Normal) });
+         result[orientation][sticker] =
+            static_cast<uint8_t>(stored / FaceStickers * FaceStride + stored % FaceStickers);
+      }
    }
 
-   SingleCubeFace &TopFace, &LeftFace, &RightFace, &BottomFace;
+   return result;
+}();
 
-   eCubeColor TopLeft, TopMiddle, TopRight;
-   eCubeColor LeftTop, LeftMiddle, LeftBottom;
-   eCubeColor RightTop, RightMiddle, RightBottom;
-   eCubeColor BottomLeft, BottomMiddle, BottomRight;
+/**
+ * @brief      For every orientation, the stored move to execute for each move, and for rotations
+ * the orientation they lead to.
+ */
+struct tOrientationMoves
+{
+   std::array<eCubeMove, EnumToInt(eCubeMove::NumMoves)> StoredMoves;
+   std::array<uint8_t, EnumToInt(eCubeMove::NumMoves)> RotatedOrientations;
 };
 
-template <int TLayer>
-static void LayerRotateZClockwise(CubeFaceData& faceData)
+static constexpr std::array<tOrientationMoves, NumOrientations> OrientationMoves = []()
 {
-   tLayerRotateZData<TLayer> layerData(faceData);
-   SetRowData<InvertLayer(TLayer), true>(layerData.TopFace, layerData.LeftTop, layerData.LeftMiddle, layerData.LeftBottom);
-   SetColData<TLayer, false>(layerData.RightFace, layerData.TopLeft, layerData.TopMiddle, layerData.TopRight);
-   SetRowData<TLayer, true>(layerData.BottomFace, layerData.RightTop, layerData.RightMiddle, layerData.RightBottom);
-   SetColData<InvertLayer(TLayer), false>(layerData.LeftFace, layerData.BottomLeft, layerData.BottomMiddle, layerData.BottomRight);
-}
+   std::array<tOrientationMoves, NumOrientations> result = {};
+   for (int orientation = 0; orientation < NumOrientations; orientation++)
+   {
+      for (int i = 0; i < EnumToInt(eCubeMove::NumMoves); i++)
+      {
+         eCubeMove move = static_cast<eCubeMove>(i);
+         const tMoveInfo& info = GetMoveInfo(move);
+
+         result[orientation].StoredMoves[i] = ToStoredMove(Orientations[orientation], move);
+         result[orientation].RotatedOrientations[i] = static_cast<uint8_t>(info.IsRotation
+               ? FindOrientation(
+                    Orientations[orientation].Rotate(info.Axis, info.QuarterTurns))
+               : orientation);
+      }
+   }
+
+   return result;
+}();
 
-template <int TLayer>
-static void LayerRotateZCounterClockwise(CubeFaceData& faceData)
+static_assert(OrientationMoves[0].StoredMoves[EnumToInt(eCubeMove::Up)] == eCubeMove::Up,
+   "The identity orientation should not remap moves.");
+static_assert(OrientationMoves[0].RotatedOrientations[EnumToInt(eCubeMove::Y)] != 0,
+   "Rotations should change the orientation.");
+
+/**
+ * @brief      Precomputed tables for conjugating a cube by one symmetry.
+ */
+struct tSymmetry
 {
-   tLayerRotateZData<TLayer> layerData(faceData);
-   SetRowData<InvertLayer(TLayer), false>(layerData.TopFace, layerData.RightTop, layerData.RightMiddle, layerData.RightBottom);
-   SetColData<TLayer, true>(layerData.RightFace, layerData.BottomLeft, layerData.BottomMiddle, layerData.BottomRight);
-   SetRowData<TLayer, false>(layerData.BottomFace, layerData.LeftTop, layerData.LeftMiddle, layerData.LeftBottom);
-   SetColData<InvertLayer(TLayer), true>(layerData.LeftFace, layerData.TopLeft, layerData.TopMiddle, layerData.TopRight);
-}
+   // Sticker i of the conjugated cube comes from sticker SourceStickers[i], in face * 9 + index order.
+   std::array<uint8_t, NumStickers> SourceStickers;
+   std::array<eCubeColor, NumFaces> ColorMap;
+   std::array<eCubeMove, EnumToInt(eCubeMove::NumMoves)> ConjugatedMoves;
+   uint8_t Inverse;
+};
 
-template <int TLayer>
-static void LayerRotateZTwice(CubeFaceData& faceData)
+/**
+ * @brief      Applies a symmetry to a direction: the optional left to right mirror, then the
+ * orientation (its columns are where the X, Y and Z axes end up).
+ */
+[[nodiscard]] static constexpr tVec3 ApplySymmetryToVector(int symmetry, const tVec3& vector)
 {
-   tLayerRotateZData<TLayer> layerData(faceData);
-   SetRowData<InvertLayer(TLayer), true>(layerData.TopFace, layerData.BottomLeft, layerData.BottomMiddle, layerData.BottomRight);
-   SetColData<TLayer, true>(layerData.RightFace, layerData.LeftTop, layerData.LeftMiddle, layerData.LeftBottom);
-   SetRowData<TLayer, true>(layerData.BottomFace, layerData.TopLeft, layerData.TopMiddle, layerData.TopRight);
-   SetColData<InvertLayer(TLayer), true>(layerData.LeftFace, layerData.RightTop, layerData.RightMiddle, layerData.RightBottom);
+   const tOrientation& orientation = Orientations[symmetry % NumOrientations];
+   int mirroredX = symmetry < NumOrientations ? vector.X : -vector.X;
+   return orientation.X * mirroredX + orientation.Y * vector.Y + orientation.Z * vector.Z;
 }
 
-static void ExecuteUp(CubeFaceData& cube)
+[[nodiscard]] static constexpr tMoveDescriptor ConjugateDescriptor(
+   int symmetry, tMoveDescriptor descriptor)
 {
-   RotateFaceClockwise(cube, eCubeFace::Top);
-   LayerRotateYClockwise<0>(cube);
+   tVec3 axis = ApplySymmetryToVector(symmetry, AxisVector(descriptor.Axis));
+   bool reverse = symmetry >= NumOrientations;
+
+   for (eCubeAxis candidate : { eCubeAxis::XAxis, eCubeAxis::YAxis, eCubeAxis::ZAxis })
+   {
+      int direction = axis.Dot(AxisVector(candidate));
+      if (direction == 0)
+      {
+         continue;
+      }
+
+      descriptor.Axis = candidate;
+      if (direction < 0)
+      {
+         // Flipping the axis mirrors the layers and reverses the turn.
+         descriptor.LayerMask = static_cast<uint8_t>(((descriptor.LayerMask & NegativeLayer) << 2) |
+            (descriptor.LayerMask & MiddleLayer) | ((descriptor.LayerMask & PositiveLayer) >> 2));
+         reverse = !reverse;
+      }
+   }
+
+   // A mirror also reverses the turn.
+   if (reverse)
+   {
+      descriptor.QuarterTurns = static_cast<uint8_t>((4 - descriptor.QuarterTurns) % 4);
+   }
+
+   return descriptor;
 }
 
-static void ExecuteUpPrime(CubeFaceData& cube)
+static constexpr std::array<tSymmetry, NumSymmetries> Symmetries = []()
 {
-   RotateFaceCounterClockwise(cube, eCubeFace::Top);
-   LayerRotateYCounterClockwise<0>(cube);
-}
+   std::array<tSymmetry, NumSymmetries> result = {};
+   for (int symmetry = 0; symmetry < NumSymmetries; symmetry++)
+   {
+      tSymmetry& entry = result[symmetry];
+      for (int sticker = 0; sticker < NumStickers; sticker++)
+      {
+         tStickerGeometry geometry = GetStickerGeometry(sticker);
+         int dst = FindSticker({ ApplySymmetryToVector(symmetry, geometry.Position),
+            ApplySymmetryToVector(symmetry, geometry.Normal) });
+         entry.SourceStickers[dst] = static_cast<uint8_t>(sticker);
+      }
 
-static void ExecuteUp2(CubeFaceData& cube)
+      // Colors follow the faces they belong to, the center of a face is where its color goes.
+      for (int face = 0; face < NumFaces; face++)
+      {
+         int center = face * FaceStickers + CubeDimsToIdx(CubeSize / 2, CubeSize / 2);
+         int dst = 0;
+         while (entry.SourceStickers[dst] != center)
+         {
+            dst++;
+         }
+
+         entry.ColorMap[face] = Cube::DefaultColorOfFace(static_cast<eCubeFace>(dst / FaceStickers));
+      }
+
+      for (int i = 0; i < EnumToInt(eCubeMove::NumMoves); i++)
+      {
+         entry.ConjugatedMoves[i] =
+            FindMove(ConjugateDescriptor(symmetry, GetMoveDescriptor(static_cast<eCubeMove>(i))));
+      }
+   }
+
+   for (int symmetry = 0; symmetry < NumSymmetries; symmetry++)
+   {
+      for (int inverse = 0; inverse < NumSymmetries; inverse++)
+      {
+         bool isInverse = true;
+         for (int sticker = 0; sticker < NumStickers; sticker++)
+         {
+            int source = result[inverse].SourceStickers[sticker];
+            isInverse = isInverse && result[symmetry].SourceStickers[source] == sticker;
+         }
+
+         if (isInverse)
+         {
+            result[symmetry].Inverse = static_cast<uint8_t>(inverse);
+         }
+      }
+   }
+
+   return result;
+}();
+
+static_assert(Symmetries[0].Inverse == 0 && Symmetries[0].SourceStickers[NumStickers - 1] ==
+   NumStickers - 1, "The first symmetry should be the identity.");
+static_assert(Symmetries[NumOrientations].ConjugatedMoves[EnumToInt(eCubeMove::Right)] ==
+   eCubeMove::LeftPrime, "Mirroring left to right should turn R into L'.");
+
+/**
+ * @brief      A corner or edge as tracked by the piece index: the stickers of its slot in the
+ * solved cube, the reference sticker first.
+ */
+struct tTrackedPiece
 {
-   RotateFaceTwice(cube, eCubeFace::Top);
-   LayerRotateYTwice<0>(cube);
-}
+   std::array<uint8_t, 3> Slots;
+   uint8_t NumStickers;
+   uint8_t ReferenceColor;
+   uint32_t ColorMask;
+};
 
-static void ExecuteDown(CubeFaceData& cube)
+[[nodiscard]] static constexpr uint8_t ToSlot(int sticker)
 {
-   RotateFaceClockwise(cube, eCubeFace::Bottom);
-   LayerRotateYCounterClockwise<2>(cube);
+   return static_cast<uint8_t>(sticker / FaceStickers * FaceStride + sticker % FaceStickers);
 }
 
-static void ExecuteDownPrime(CubeFaceData& cube)
+/**
+ * @brief      Every corner and edge. The reference sticker is the one on the top or bottom face, or
+ * on the front or back face for middle layer edges.
+ */
+static constexpr std::array<tTrackedPiece, NumTrackedPieces> TrackedPieces = []()
 {
-   RotateFaceCounterClockwise(cube, eCubeFace::Bottom);
-   LayerRotateYClockwise<2>(cube);
-}
+   std::array<tTrackedPiece, NumTrackedPieces> result = {};
+   int count = 0;
+   for (int x = -1; x <= 1; x++)
+   {
+      for (int y = -1; y <= 1; y++)
+      {
+         for (int z = -1; z <= 1; z++)
+         {
+            std::array<int, 3> stickers = {};
+            int numStickers = GetPieceStickers({ x, y, z }, stickers);
+            if (numStickers < 2)
+            {
+               continue;
+            }
+
+            auto isReference = [](int sticker, int axis)
+            {
+               tVec3 normal = GetStickerGeometry(sticker).Normal;
+               return axis == 1 ? normal.Y != 0 : normal.Z != 0;
+            };
+
+            // Stickers are found in face order, top and bottom first.
+            int reference = 0;
+            if (!isReference(stickers[0], 1))
+            {
+               while (!isReference(stickers[reference], 2))
+               {
+                  reference++;
+               }
+            }
+
+            tTrackedPiece& piece = result[count++];
+            piece.NumStickers = static_cast<uint8_t>(numStickers);
+            piece.Slots[0] = ToSlot(stickers[reference]);
+            for (int i = 0, j = 1; i < numStickers; i++)
+            {
+               if (i != reference)
+               {
+                  piece.Slots[j++] = ToSlot(stickers[i]);
+               }
+            }
+
+            for (int i = 0; i < numStickers; i++)
+            {
+               piece.ColorMask |= 1u << (piece.Slots[i] / FaceStride);
+            }
+
+            piece.ReferenceColor = static_cast<uint8_t>(
+               Cube::DefaultColorOfFace(static_cast<eCubeFace>(piece.Slots[0] / FaceStride)));
+         }
+      }
+   }
+
+   return result;
+}();
+
+constexpr uint8_t NoPiece = 0xFF;
+constexpr int NumColorMasks = 1 << EnumToInt(eCubeColor::NumColors);
 
-static void ExecuteDown2(CubeFaceData& cube)
+/**
+ * @brief      The tracked piece with the given colors, indexed by one bit per color.
+ */
+static constexpr std::array<uint8_t, NumColorMasks> PieceOfColors = []()
 {
-   RotateFaceTwice(cube, eCubeFace::Bottom);
-   LayerRotateYTwice<2>(cube);
-}
+   std::array<uint8_t, NumColorMasks> result = {};
+   for (auto& entry : result)
+   {
+      entry = NoPiece;
+   }
 
-static void ExecuteRight(CubeFaceData& cube)
+   for (int piece = 0; piece < NumTrackedPieces; piece++)
+   {
+      result[TrackedPieces[piece].ColorMask] = static_cast<uint8_t>(piece);
+   }
+
+   return result;
+}();
+
+/**
+ * @brief      For every stored slot, the tracked piece whose solved slots include it. Centers and
+ * padding have none.
+ */
+static constexpr std::array<uint8_t, NumFaces * FaceStride> HomeOfSlot = []()
 {
-   RotateFaceClockwise(cube, eCubeFace::Right);
-   LayerRotateXClockwise<2>(cube);
+   std::array<uint8_t, NumFaces * FaceStride> result = {};
+   for (auto& entry : result)
+   {
+      entry = NoPiece;
+   }
+
+   for (int piece = 0; piece < NumTrackedPieces; piece++)
+   {
+      for (int i = 0; i < TrackedPieces[piece].NumStickers; i++)
+      {
+         result[TrackedPieces[piece].Slots[i]] = static_cast<uint8_t>(piece);
+      }
+   }
+
+   return result;
+}();
+
+/**
+ * @brief      Identifies the piece whose stickers are in the given slots.
+ *
+ * @param[in]  faceData       The stored stickers
+ * @param[in]  slotStickers   The slots of one corner or edge, see TrackedPieces
+ * @param      referenceSlot  The slot holding the reference sticker of the piece, if there is one
+ *
+ * @return     The piece, or NoPiece if the colors don't make one.
+ */
+static uint8_t FindPieceInSlots(
+   const CubeFaceData& faceData, const tTrackedPiece& slotStickers, uint8_t& referenceSlot)
+{
+   uint32_t colorMask = 0;
+   for (int i = 0; i < slotStickers.NumStickers; i++)
+   {
+      int slot = slotStickers.Slots[i];
+      colorMask |= 1u << (EnumToInt(faceData[slot / FaceStride][slot % FaceStride]) & 0x1F);
+   }
+
+   uint8_t piece = colorMask < NumColorMasks ? PieceOfColors[colorMask] : NoPiece;
+   if (piece == NoPiece)
+   {
+      return NoPiece;
+   }
+
+   for (int i = 0; i < slotStickers.NumStickers; i++)
+   {
+      int slot = slotStickers.Slots[i];
+      if (EnumToInt(faceData[slot / FaceStride][slot % FaceStride]) ==
+          TrackedPieces[piece].ReferenceColor)
+      {
+         referenceSlot = static_cast<uint8_t>(slot);
+      }
+   }
+
+   return piece;
 }
 
-static void ExecuteRightPrime(CubeFaceData& cube)
+/**
+ * @brief      For every stored slot, the position of its piece as an index between 0 and 26.
+ */
+static constexpr std::array<uint8_t, NumFaces * FaceStride> PositionOfSlot = []()
 {
-   RotateFaceCounterClockwise(cube, eCubeFace::Right);
-   LayerRotateXCounterClockwise<2>(cube);
-}
+   std::array<uint8_t, NumFaces * FaceStride> result = {};
+   for (auto& entry : result)
+   {
+      entry = NoPiece;
+   }
+
+   for (int sticker = 0; sticker < NumStickers; sticker++)
+   {
+      tVec3 position = GetStickerGeometry(sticker).Position;
+      result[ToSlot(sticker)] =
+         static_cast<uint8_t>((position.X + 1) * 9 + (position.Y + 1) * 3 + position.Z + 1);
+   }
+
+   return result;
+}();
 
-static void ExecuteRight2(CubeFaceData& cube)
+/**
+ * @brief      For every move, where the sticker in each stored slot ends up. Every byte value has an
+ * entry so NoPiece maps to itself without a branch.
+ */
+static constexpr std::array<std::array<uint8_t, 256>, EnumToInt(eCubeMove::NumMoves)>
+   MoveDestinations = []()
 {
-   RotateFaceTwice(cube, eCubeFace::Right);
-   LayerRotateXTwice<2>(cube);
-}
+   std::array<std::array<uint8_t, 256>, EnumToInt(eCubeMove::NumMoves)> result = {};
+   for (int move = 0; move < EnumToInt(eCubeMove::NumMoves); move++)
+   {
+      for (int slot = 0; slot < 256; slot++)
+      {
+         result[move][slot] = static_cast<uint8_t>(slot);
+      }
+
+      const tMoveKernel& kernel = GeneratedMoveKernels[move];
+      for (int i = 0; i < kernel.NumChanged; i++)
+      {
+         result[move][kernel.Src[i]] = kernel.Dst[i];
+      }
+   }
+
+   return result;
+}();
+
+/**
+ * @brief      For every orientation, the seen sticker (face * 9 + index) each stored slot shows up
+ * as. The inverse of the orientation slots used by GetStickerSlot.
+ */
+static constexpr std::array<std::array<uint8_t, NumFaces * FaceStride>, NumOrientations>
+   SeenStickers = []()
+{
+   std::array<std::array<uint8_t, NumFaces * FaceStride>, NumOrientations> result = {};
+   for (int orientation = 0; orientation < NumOrientations; orientation++)
+   {
+      for (int sticker = 0; sticker < NumStickers; sticker++)
+      {
+         tStickerGeometry geometry = GetStickerGeometry(sticker);
+         int stored = FindSticker({ Orientations[orientation].ToStored(geometry.Position),
+            Orientations[orientation].ToStored(geometry.Normal) });
+         result[orientation][ToSlot(stored)] = static_cast<uint8_t>(sticker);
+      }
+   }
+
+   return result;
+}();
+
+using MoveShuffles = std::array<tMoveShuffle, EnumToInt(eCubeMove::NumMoves)>;
 
-static void ExecuteLeft(CubeFaceData& cube)
+/**
+ * @brief      Builds the shuffle of every move by running its kernel on a cube where every sticker
+ * holds its own position instead of a color.
+ */
+static const MoveShuffles& GetMoveShuffles()
 {
-   RotateFaceClockwise(cube, eCubeFace::Left);
-   LayerRotateXCounterClockwise<0>(cube);
+   static const MoveShuffles shuffles = []()
+   {
+      MoveShuffles result;
+      for (int i = 0; i < EnumToInt(eCubeMove::NumMoves); i++)
+      {
+         CubeFaceData labeledCube;
+         for (int slot = 0; slot < NumFaces * FaceStride; slot++)
+         {
+            labeledCube[slot / FaceStride][slot % FaceStride] = static_cast<eCubeColor>(slot);
+         }
+
+         MoveFunctions[i](labeledCube);
+         result[i] = BuildMoveShuffle(labeledCube);
+      }
+
+      return result;
+   }();
+
+   return shuffles;
 }
 
-static void ExecuteLeftPrime(CubeFaceData& cube)
+using OrientationShuffles = std::array<tMoveShuffle, NumOrientations>;
+
+/**
+ * @brief      Builds, for every orientation, the shuffle storing the stickers the way they are seen
+ * through it, see Cube::Flatten. Orientations turn the whole cube, so every face comes from a
+ * single face and the cheaper move shuffles are enough.
+ */
+static const OrientationShuffles& GetOrientationShuffles()
 {
-   RotateFaceCounterClockwise(cube, eCubeFace::Left);
-   LayerRotateXClockwise<0>(cube);
+   static const OrientationShuffles shuffles = []()
+   {
+      OrientationShuffles result;
+      for (int orientation = 0; orientation < NumOrientations; orientation++)
+      {
+         CubeFaceData labeledResult = {};
+         for (int sticker = 0; sticker < NumStickers; sticker++)
+         {
+            int slot = ToSlot(sticker);
+            labeledResult[slot / FaceStride][slot % FaceStride] = static_cast<eCubeColor>(
+               Cube::GetOrientationSlot(orientation, static_cast<eCubeFace>(sticker / FaceStickers),
+                  sticker % FaceStickers % CubeSize, sticker % FaceStickers / CubeSize));
+         }
+
+         result[orientation] = BuildMoveShuffle(labeledResult);
+      }
+
+      return result;
+   }();
+
+   return shuffles;
 }
 
-static void ExecuteLeft2(CubeFaceData& cube)
+static eMoveEngine sMoveEngine =
+   IsShuffleEngineSupported() ? eMoveEngine::Shuffle : eMoveEngine::Scalar;
+
+bool Cube::IsMoveEngineSupported(eMoveEngine engine)
 {
-   RotateFaceTwice(cube, eCubeFace::Left);
-   LayerRotateXTwice<0>(cube);
+   switch (engine)
+   {
+   case eMoveEngine::Scalar:
+      return true;
+   case eMoveEngine::Shuffle:
+      return IsShuffleEngineSupported();
+   default:
+      return false;
+   }
 }
 
-static void ExecuteFront(CubeFaceData& cube)
+void Cube::SetMoveEngine(eMoveEngine engine)
 {
-   RotateFaceClockwise(cube, eCubeFace::Front);
-   LayerRotateZClockwise<0>(cube);
+   assert(IsMoveEngineSupported(engine) && "Move engine is not supported on this CPU.");
+   sMoveEngine = engine;
 }
 
-static void ExecuteFrontPrime(CubeFaceData& cube)
+eMoveEngine Cube::GetMoveEngine()
 {
-   RotateFaceCounterClockwise(cube, eCubeFace::Front);
-   LayerRotateZCounterClockwise<0>(cube);
+   return sMoveEngine;
 }
 
-static void ExecuteFront2(CubeFaceData& cube)
+void Cube::ExecuteMove(eCubeMove move)
 {
-   RotateFaceTwice(cube, eCubeFace::Front);
-   LayerRotateZTwice<0>(cube);
+   if (EnumToInt(move) >= EnumToInt(eCubeMove::NumMoves))
+   {
+      std::cout << "Invalid move " << EnumToInt(move) << "\n";
+      return;
+   }
+
+   const tOrientationMoves& orientationMoves = OrientationMoves[mOrientation];
+   if (mVirtualRotations && GetMoveInfo(move).IsRotation)
+   {
+      mOrientation = orientationMoves.RotatedOrientations[EnumToInt(move)];
+      return;
+   }
+
+   move = orientationMoves.StoredMoves[EnumToInt(move)];
+   if (sMoveEngine == eMoveEngine::Shuffle)
+   {
+      ExecuteMoveShuffle(mCube, GetMoveShuffles()[EnumToInt(move)]);
+   }
+   else
+   {
+      MoveFunctions[EnumToInt(move)](mCube);
+   }
+
+   if (mTrackPieces)
+   {
+      const auto& destinations = MoveDestinations[EnumToInt(move)];
+      for (uint8_t& slot : mPieceSlots)
+      {
+         slot = destinations[slot];
+      }
+   }
 }
 
-static void ExecuteBack(CubeFaceData& cube)
+void Cube::ExecuteMoves(const eCubeMove* moves, size_t numMoves)
 {
-   RotateFaceClockwise(cube, eCubeFace::Back);
-   LayerRotateZCounterClockwise<2>(cube);
+   ExecuteMoves(std::span<const eCubeMove>(moves, numMoves));
 }
 
-static void ExecuteBackPrime(CubeFaceData& cube)
-{
-   RotateFaceCounterClockwise(cube, eCubeFace::Back);
-   LayerRotateZClockwise<2>(cube);
-}
+void Cube::ExecuteMoves(std::span<const eCubeMove> moves)
+{
+   // Large enough to amortize the dispatch, small enough for the decoded block to stay in L1.
+   constexpr size_t BlockSize = 256;
+   std::array<eCubeMove, BlockSize> storedMoves;
+   std::array<const tMoveShuffle*, BlockSize> shuffles;
+   const MoveShuffles* moveShuffles =
+      sMoveEngine == eMoveEngine::Shuffle ? &GetMoveShuffles() : nullptr;
+
+   while (!moves.empty())
+   {
+      std::span<const eCubeMove> block = moves.first(std::min(moves.size(), BlockSize));
+      moves = moves.subspan(block.size());
+
+      // Decode the block into the moves applied to the stored stickers. Virtual rotations only
+      // change the orientation the following moves are remapped through.
+      size_t numStored = 0;
+      for (eCubeMove move : block)
+      {
+         if (EnumToInt(move) >= EnumToInt(eCubeMove::NumMoves))
+         {
+            std::cout << "Invalid move " << EnumToInt(move) << "\n";
+            continue;
+         }
+
+         const tOrientationMoves& orientationMoves = OrientationMoves[mOrientation];
+         if (mVirtualRotations && GetMoveInfo(move).IsRotation)
+         {
+            mOrientation = orientationMoves.RotatedOrientations[EnumToInt(move)];
+            continue;
+         }
+
+         storedMoves[numStored++] = orientationMoves.StoredMoves[EnumToInt(move)];
+      }
+
+      if (moveShuffles)
+      {
+         for (size_t i = 0; i < numStored; i++)
+         {
+            shuffles[i] = &(*moveShuffles)[EnumToInt(storedMoves[i])];
+         }
 
-static void ExecuteBack2(CubeFaceData& cube)
-{
-   RotateFaceTwice(cube, eCubeFace::Back);
-   LayerRotateZTwice<2>(cube);
-}
-static void ExecuteMiddle(CubeFaceData& cube)
-{
-   LayerRotateXCounterClockwise<1>(cube);
-}
+         ExecuteMoveShuffles(mCube, shuffles.data(), numStored);
+      }
+      else
+      {
+         alignas(16) CubeFaceData stickers = mCube;
+         for (size_t i = 0; i < numStored; i++)
+         {
+            MoveFunctions[EnumToInt(storedMoves[i])](stickers);
+         }
 
-static void ExecuteMiddlePrime(CubeFaceData& cube)
-{
-   LayerRotateXClockwise<1>(cube);
-}
+         mCube = stickers;
+      }
 
-static void ExecuteMiddle2(CubeFaceData& cube)
-{
-   LayerRotateXTwice<1>(cube);
+      if (mTrackPieces)
+      {
+         for (size_t i = 0; i < numStored; i++)
+         {
+            const auto& destinations = MoveDestinations[EnumToInt(storedMoves[i])];
+            for (uint8_t& slot : mPieceSlots)
+            {
+               slot = destinations[slot];
+            }
+         }
+      }
+   }
 }
 
-static void ExecuteEquator(CubeFaceData& cube)
+void Cube::SetVirtualRotations(bool enabled)
 {
-   LayerRotateYCounterClockwise<1>(cube);
-}
+   if (!enabled)
+   {
+      Flatten();
+   }
 
-static void ExecuteEquatorPrime(CubeFaceData& cube)
-{
-   LayerRotateYClockwise<1>(cube);
+   mVirtualRotations = enabled;
 }
 
-static void ExecuteEquator2(CubeFaceData& cube)
+uint64_t Cube::HashFaceData(const CubeFaceData& faceData)
 {
-   LayerRotateYTwice<1>(cube);
-}
+   static_assert(FaceStickers == 9 && sizeof(eCubeColor) == 1, "A face is hashed as 8 + 1 bytes.");
 
-static void ExecuteStanding(CubeFaceData& cube)
-{
-   LayerRotateZClockwise<1>(cube);
-}
+   uint64_t hash = 0;
+   for (int face = 0; face < NumFaces; face++)
+   {
+      // Colors only use the low 3 bits of each byte, so the ninth sticker fits in the unused top
+      // bits of the first eight and the face packs into one word without collisions.
+      uint64_t word;
+      std::memcpy(&word, faceData[face].data(), sizeof(word));
+      word |= static_cast<uint64_t>(faceData[face][FaceStickers - 1]) << 59;
+
+      hash = (hash ^ word) * 0x9E3779B97F4A7C15ull;
+      hash ^= hash >> 32;
+   }
 
-static void ExecuteStandingPrime(CubeFaceData& cube)
-{
-   LayerRotateZCounterClockwise<1>(cube);
+   // Final avalanche so every input bit affects every output bit (splitmix64 finalizer).
+   hash ^= hash >> 30;
+   hash *= 0xBF58476D1CE4E5B9ull;
+   hash ^= hash >> 27;
+   hash *= 0x94D049BB133111EBull;
+   hash ^= hash >> 31;
+   return hash;
 }
 
-static void ExecuteStanding2(CubeFaceData& cube)
+uint64_t Cube::Hash() const
 {
-   LayerRotateZTwice<1>(cube);
-}
+   if (mOrientation == 0)
+   {
+      return HashFaceData(mCube);
+   }
 
-static void ExecuteX(CubeFaceData& cube)
-{
-   // Rotate the whole cube on the X axis. It's not inefficient to call the moves since each
-   // move is independent.
-   ExecuteRight(cube);
-   ExecuteLeftPrime(cube);
-   ExecuteMiddlePrime(cube);
+   CubeFaceData faceData;
+   CopyFaceData(faceData);
+   return HashFaceData(faceData);
 }
 
-static void ExecuteXPrime(CubeFaceData& cube)
+bool Cube::operator==(const Cube& other) const
 {
-   ExecuteRightPrime(cube);
-   ExecuteLeft(cube);
-   ExecuteMiddle(cube);
-}
+   if (mOrientation == 0 && other.mOrientation == 0)
+   {
+      // Padding bytes are ignored, only the stickers are compared.
+      for (int face = 0; face < NumFaces; face++)
+      {
+         if (std::memcmp(mCube[face].data(), other.mCube[face].data(), FaceStickers) != 0)
+         {
+            return false;
+         }
+      }
 
-static void ExecuteX2(CubeFaceData& cube)
-{
-   ExecuteRight2(cube);
-   ExecuteLeft2(cube);
-   ExecuteMiddle2(cube);
-}
+      return true;
+   }
 
-static void ExecuteUpWide(CubeFaceData& cube)
-{
-   ExecuteUp(cube);
-   ExecuteEquatorPrime(cube);
-}
+   for (int sticker = 0; sticker < NumStickers; sticker++)
+   {
+      eCubeFace face = static_cast<eCubeFace>(sticker / FaceStickers);
+      int x = sticker % FaceStickers % CubeSize;
+      int y = sticker % FaceStickers / CubeSize;
+      if (GetState(face, x, y) != other.GetState(face, x, y))
+      {
+         return false;
+      }
+   }
 
-static void ExecuteUpWidePrime(CubeFaceData& cube)
-{
-   ExecuteUpPrime(cube);
-   ExecuteEquator(cube);
+   return true;
 }
 
-static void ExecuteUpWide2(CubeFaceData& cube)
+void Cube::Flatten()
 {
-   ExecuteUp2(cube);
-   ExecuteEquator2(cube);
-}
+   if (mOrientation == 0)
+   {
+      return;
+   }
 
-static void ExecuteDownWide(CubeFaceData& cube)
-{
-   ExecuteDown(cube);
-   ExecuteEquator(cube);
-}
+   // Storing the stickers as they are seen is a fixed permutation per orientation, and the piece
+   // index only needs its slots moved along.
+   if (sMoveEngine == eMoveEngine::Shuffle)
+   {
+      ExecuteMoveShuffle(mCube, GetOrientationShuffles()[mOrientation]);
+   }
+   else
+   {
+      CubeFaceData source = mCube;
+      for (int sticker = 0; sticker < NumStickers; sticker++)
+      {
+         int sourceSlot = sOrientationSlots[mOrientation][sticker];
+         int slot = ToSlot(sticker);
+         mCube[slot / FaceStride][slot % FaceStride] =
+            source[sourceSlot / FaceStride][sourceSlot % FaceStride];
+      }
+   }
 
-static void ExecuteDownWidePrime(CubeFaceData& cube)
-{
-   ExecuteDownPrime(cube);
-   ExecuteEquatorPrime(cube);
-}
+   if (mTrackPieces)
+   {
+      for (uint8_t& slot : mPieceSlots)
+      {
+         if (slot != NoPiece)
+         {
+            slot = ToSlot(SeenStickers[mOrientation][slot]);
+         }
+      }
+   }
 
-static void ExecuteDownWide2(CubeFaceData& cube)
-{
-   ExecuteDown2(cube);
-   ExecuteEquator2(cube);
+   mOrientation = 0;
 }
 
-static void ExecuteRightWide(CubeFaceData& cube)
+void Cube::CopyFaceData(CubeFaceData& faceData) const
 {
-   ExecuteRight(cube);
-   ExecuteMiddlePrime(cube);
+   faceData = {};
+   for (int face = 0; face < NumFaces; face++)
+   {
+      for (int idx = 0; idx < FaceStickers; idx++)
+      {
+         faceData[face][idx] = GetState(static_cast<eCubeFace>(face), idx % CubeSize, idx / CubeSize);
+      }
+   }
 }
 
-static void ExecuteRightWidePrime(CubeFaceData& cube)
+void Cube::SetPieceTracking(bool enabled)
 {
-   ExecuteRightPrime(cube);
-   ExecuteMiddle(cube);
+   mTrackPieces = enabled;
+   if (enabled)
+   {
+      RebuildPieceIndex();
+   }
 }
 
-static void ExecuteRightWide2(CubeFaceData& cube)
+void Cube::RebuildPieceIndex()
 {
-   ExecuteRight2(cube);
-   ExecuteMiddle2(cube);
-}
+   mPieceSlots.fill(NoPiece);
 
-static void ExecuteLeftWide(CubeFaceData& cube)
-{
-   ExecuteLeft(cube);
-   ExecuteMiddle(cube);
+   // Whatever piece sits in each slot of the stored stickers, even if they are seen rotated.
+   for (const tTrackedPiece& slotStickers : TrackedPieces)
+   {
+      uint8_t referenceSlot = NoPiece;
+      uint8_t piece = FindPieceInSlots(mCube, slotStickers, referenceSlot);
+      if (piece != NoPiece)
+      {
+         mPieceSlots[piece] = referenceSlot;
+      }
+   }
 }
 
-static void ExecuteLeftWidePrime(CubeFaceData& cube)
+void Cube::SetTrackedSticker(int slot, eCubeColor color)
 {
-   ExecuteLeftPrime(cube);
-   ExecuteMiddlePrime(cube);
-}
+   uint8_t home = HomeOfSlot[slot];
+   if (home == NoPiece)
+   {
+      mCube[slot / FaceStride][slot % FaceStride] = color;
+      return;
+   }
 
-static void ExecuteLeftWide2(CubeFaceData& cube)
-{
-   ExecuteLeft2(cube);
-   ExecuteMiddle2(cube);
-}
+   uint8_t referenceSlot = NoPiece;
+   uint8_t previousPiece = FindPieceInSlots(mCube, TrackedPieces[home], referenceSlot);
+   mCube[slot / FaceStride][slot % FaceStride] = color;
+   uint8_t piece = FindPieceInSlots(mCube, TrackedPieces[home], referenceSlot);
 
-static void ExecuteFrontWide(CubeFaceData& cube)
-{
-   ExecuteFront(cube);
-   ExecuteStanding(cube);
-}
+   // While stickers are written one at a time the piece that was here can also be somewhere else,
+   // look for that copy before dropping it from the index.
+   if (previousPiece != NoPiece && previousPiece != piece &&
+       mPieceSlots[previousPiece] != NoPiece && HomeOfSlot[mPieceSlots[previousPiece]] == home)
+   {
+      mPieceSlots[previousPiece] = NoPiece;
+      for (const tTrackedPiece& slotStickers : TrackedPieces)
+      {
+         uint8_t otherSlot = NoPiece;
+         if (FindPieceInSlots(mCube, slotStickers, otherSlot) == previousPiece)
+         {
+            mPieceSlots[previousPiece] = otherSlot;
+            break;
+         }
+      }
+   }
 
-static void ExecuteFrontWidePrime(CubeFaceData& cube)
-{
-   ExecuteFrontPrime(cube);
-   ExecuteStandingPrime(cube);
+   if (piece != NoPiece)
+   {
+      mPieceSlots[piece] = referenceSlot;
+   }
 }
 
-static void ExecuteFrontWide2(CubeFaceData& cube)
+int Cube::GetPieceSlot(uint32_t colorMask) const
 {
-   ExecuteFront2(cube);
-   ExecuteStanding2(cube);
-}
+   assert(mTrackPieces && "The piece index is not enabled.");
 
-static void ExecuteBackWide(CubeFaceData& cube)
-{
-   ExecuteBack(cube);
-   ExecuteStandingPrime(cube);
-}
+   uint8_t piece = colorMask < NumColorMasks ? PieceOfColors[colorMask] : NoPiece;
+   if (piece == NoPiece || mPieceSlots[piece] == NoPiece)
+   {
+      return -1;
+   }
 
-static void ExecuteBackWidePrime(CubeFaceData& cube)
-{
-   ExecuteBackPrime(cube);
-   ExecuteStanding(cube);
+   return mPieceSlots[piece];
 }
 
-static void ExecuteBackWide2(CubeFaceData& cube)
+bool Cube::IsPieceAt(eCubeColor color1, eCubeColor color2, eCubeFace face, int x, int y) const
 {
-   ExecuteBack2(cube);
-   ExecuteStanding2(cube);
+   int pieceSlot = GetPieceSlot((1u << EnumToInt(color1)) | (1u << EnumToInt(color2)));
+   return pieceSlot >= 0 && PositionOfSlot[pieceSlot] == PositionOfSlot[GetStickerSlot(face, x, y)];
 }
 
-static void ExecuteY(CubeFaceData& cube)
+bool Cube::IsPieceAt(
+   eCubeColor color1, eCubeColor color2, eCubeColor color3, eCubeFace face, int x, int y) const
 {
-   ExecuteUp(cube);
-   ExecuteDownPrime(cube);
-   ExecuteEquatorPrime(cube);
+   int pieceSlot = GetPieceSlot(
+      (1u << EnumToInt(color1)) | (1u << EnumToInt(color2)) | (1u << EnumToInt(color3)));
+   return pieceSlot >= 0 && PositionOfSlot[pieceSlot] == PositionOfSlot[GetStickerSlot(face, x, y)];
 }
 
-static void ExecuteYPrime(CubeFaceData& cube)
+/**
+ * @brief      Converts a seen sticker index to its face and coordinates.
+ */
+static void ToFaceCoordinates(int sticker, eCubeFace& face, int& x, int& y)
 {
-   ExecuteUpPrime(cube);
-   ExecuteDown(cube);
-   ExecuteEquator(cube);
+   face = static_cast<eCubeFace>(sticker / FaceStickers);
+   x = sticker % FaceStickers % CubeSize;
+   y = sticker % FaceStickers / CubeSize;
 }
 
-static void ExecuteY2(CubeFaceData& cube)
+bool Cube::LocatePiece(eCubeColor color1, eCubeColor color2, eCubeFace& face, int& x, int& y) const
 {
-   ExecuteUp2(cube);
-   ExecuteDown2(cube);
-   ExecuteEquator2(cube);
-}
+   int pieceSlot = GetPieceSlot((1u << EnumToInt(color1)) | (1u << EnumToInt(color2)));
+   if (pieceSlot < 0)
+   {
+      return false;
+   }
 
-static void ExecuteZ(CubeFaceData& cube)
-{
-   ExecuteFront(cube);
-   ExecuteStanding(cube);
-   ExecuteBackPrime(cube);
+   ToFaceCoordinates(SeenStickers[mOrientation][pieceSlot], face, x, y);
+   return true;
 }
 
-static void ExecuteZPrime(CubeFaceData& cube)
+bool Cube::LocatePiece(eCubeColor color1, eCubeColor color2, eCubeColor color3, eCubeFace& face,
+   int& x, int& y) const
 {
-   ExecuteFrontPrime(cube);
-   ExecuteStandingPrime(cube);
-   ExecuteBack(cube);
-}
+   int pieceSlot = GetPieceSlot(
+      (1u << EnumToInt(color1)) | (1u << EnumToInt(color2)) | (1u << EnumToInt(color3)));
+   if (pieceSlot < 0)
+   {
+      return false;
+   }
 
-static void ExecuteZ2(CubeFaceData& cube)
-{
-   ExecuteFront2(cube);
-   ExecuteStanding2(cube);
-   ExecuteBack2(cube);
+   ToFaceCoordinates(SeenStickers[mOrientation][pieceSlot], face, x, y);
+   return true;
 }
 
-Cube::Cube()
+void Cube::ExecuteAlgorithm(const CompiledAlgorithm& algorithm)
 {
-   static_assert(
-      EnumToInt(eCubeColor::Yellow) == EnumToInt(eCubeFace::Top), "Incorrect cube config.");
-   static_assert(
-      EnumToInt(eCubeColor::White) == EnumToInt(eCubeFace::Bottom), "Incorrect cube config.");
-   static_assert(
-      EnumToInt(eCubeColor::Red) == EnumToInt(eCubeFace::Left), "Incorrect cube config.");
-   static_assert(
-      EnumToInt(eCubeColor::Orange) == EnumToInt(eCubeFace::Right), "Incorrect cube config.");
-   static_assert(
-      EnumToInt(eCubeColor::Green) == EnumToInt(eCubeFace::Front), "Incorrect cube config.");
-   static_assert(
-      EnumToInt(eCubeColor::Blue) == EnumToInt(eCubeFace::Back), "Incorrect cube config.");
+   // The permutation is expressed on the stickers as they are seen.
+   Flatten();
 
-   SetSolved();
-}
+   if (mTrackPieces)
+   {
+      for (uint8_t& slot : mPieceSlots)
+      {
+         if (slot != NoPiece)
+         {
+            slot = static_cast<uint8_t>(algorithm.GetDestinationSlot(slot));
+         }
+      }
+   }
 
-void Cube::SetSolved()
-{
-   for (int i = 0; i < EnumToInt(eCubeColor::NumColors); i++)
+   if (sMoveEngine == eMoveEngine::Shuffle)
    {
-      eCubeColor color = static_cast<eCubeColor>(i);
-      int face = EnumToInt(DefaultFaceOfColor(color));
+      ExecutePermutationShuffle(mCube, algorithm.GetShuffle());
+      return;
+   }
 
-      for (int i = 0; i < mCube[face].size(); i++)
+   CubeFaceData source = mCube;
+   for (int face = 0; face < EnumToInt(eCubeFace::NumFaces); face++)
+   {
+      for (int idx = 0; idx < CubeSize * CubeSize; idx++)
       {
-         mCube[face][i] = color;
+         int sourceSlot = algorithm.GetSourceSlot(face * FaceStride + idx);
+         mCube[face][idx] = source[sourceSlot / FaceStride][sourceSlot % FaceStride];
       }
    }
 }
 
-bool Cube::IsSolved()
+void Cube::ApplySymmetry(int symmetry)
 {
-   if (!Validate())
+   assert(symmetry >= 0 && symmetry < NumSymmetries && "Invalid symmetry.");
+   const tSymmetry& entry = Symmetries[symmetry];
+
+   CubeFaceData source;
+   CopyFaceData(source);
+
+   CubeFaceData faceData = {};
+   for (int sticker = 0; sticker < NumStickers; sticker++)
    {
-      return false;
+      int src = entry.SourceStickers[sticker];
+      eCubeColor color = source[src / FaceStickers][src % FaceStickers];
+      faceData[sticker / FaceStickers][sticker % FaceStickers] = entry.ColorMap[EnumToInt(color)];
    }
 
-   // Now ensure each side has the same color.
-   for (int i = 0; i < EnumToInt(eCubeFace::NumFaces); i++)
+   SetFaceData(faceData);
+}
+
+int Cube::Canonicalize()
+{
+   std::array<eCubeColor, NumStickers> stickers;
+   for (int sticker = 0; sticker < NumStickers; sticker++)
    {
-      eCubeFace face = static_cast<eCubeFace>(i);
-      eCubeColor color = ColorOfFace(face);
-      SingleCubeFace& faceData = mCube[i];
+      stickers[sticker] = GetState(static_cast<eCubeFace>(sticker / FaceStickers),
+         sticker % FaceStickers % CubeSize, sticker % FaceStickers / CubeSize);
+   }
 
-      for (int j = 0; j < CubeSize; j++)
+   // Lowest conjugated stickers so far. Most symmetries lose within the first few stickers, so the
+   // comparison is done while conjugating and stops as soon as the candidate is known to be higher.
+   std::array<eCubeColor, NumStickers> best = stickers;
+   int bestSymmetry = 0;
+   for (int symmetry = 1; symmetry < NumSymmetries; symmetry++)
+   {
+      const tSymmetry& entry = Symmetries[symmetry];
+      for (int sticker = 0; sticker < NumStickers; sticker++)
       {
-         for (int k = 0; k < CubeSize; k++)
+         eCubeColor color = entry.ColorMap[EnumToInt(stickers[entry.SourceStickers[sticker]])];
+         if (color > best[sticker])
+         {
+            break;
+         }
+
+         if (color < best[sticker])
          {
-            if (faceData[CubeDimsToIdx(j, k)] != color)
+            bestSymmetry = symmetry;
+            for (; sticker < NumStickers; sticker++)
             {
-               return false;
+               best[sticker] = entry.ColorMap[EnumToInt(stickers[entry.SourceStickers[sticker]])];
             }
          }
       }
    }
 
-   return true;
+   CubeFaceData faceData = {};
+   for (int sticker = 0; sticker < NumStickers; sticker++)
+   {
+      faceData[sticker / FaceStickers][sticker % FaceStickers] = best[sticker];
+   }
+
+   SetFaceData(faceData);
+   return bestSymmetry;
 }
 
-bool Cube::Validate()
+int Cube::InverseSymmetry(int symmetry)
 {
-   return true;
+   assert(symmetry >= 0 && symmetry < NumSymmetries && "Invalid symmetry.");
+   return Symmetries[symmetry].Inverse;
 }
 
-void Cube::ExecuteMoves(eCubeMove* moves, size_t numMoves)
+eCubeMove Cube::ConjugateMove(eCubeMove move, int symmetry)
 {
-   for (size_t i = 0; i < numMoves; i++)
-   {
-      ExecuteMove(moves[i]);
-   }
+   assert(symmetry >= 0 && symmetry < NumSymmetries && "Invalid symmetry.");
+   assert(EnumToInt(move) < EnumToInt(eCubeMove::NumMoves) && "Invalid move");
+   return Symmetries[symmetry].ConjugatedMoves[EnumToInt(move)];
 }
 
-void Cube::ExecuteMove(eCubeMove move)
+void Cube::ExecuteMovesParallel(const eCubeMove* moves, size_t numMoves, unsigned numThreads)
 {
-   switch (move)
-   {
-   case eCubeMove::Up:
-      ExecuteUp(mCube);
-      break;
-   case eCubeMove::UpPrime:
-      ExecuteUpPrime(mCube);
-      break;
-   case eCubeMove::Up2:
-      ExecuteUp2(mCube);
-      break;
-   case eCubeMove::Down:
-      ExecuteDown(mCube);
-      break;
-   case eCubeMove::DownPrime:
-      ExecuteDownPrime(mCube);
-      break;
-   case eCubeMove::Down2:
-      ExecuteDown2(mCube);
-      break;
-   case eCubeMove::Right:
-      ExecuteRight(mCube);
-      break;
-   case eCubeMove::RightPrime:
-      ExecuteRightPrime(mCube);
-      break;
-   case eCubeMove::Right2:
-      ExecuteRight2(mCube);
-      break;
-   case eCubeMove::Left:
-      ExecuteLeft(mCube);
-      break;
-   case eCubeMove::LeftPrime:
-      ExecuteLeftPrime(mCube);
-      break;
-   case eCubeMove::Left2:
-      ExecuteLeft2(mCube);
-      break;
-   case eCubeMove::Front:
-      ExecuteFront(mCube);
-      break;
-   case eCubeMove::FrontPrime:
-      ExecuteFrontPrime(mCube);
-      break;
-   case eCubeMove::Front2:
-      ExecuteFront2(mCube);
-      break;
-   case eCubeMove::Back:
-      ExecuteBack(mCube);
-      break;
-   case eCubeMove::BackPrime:
-      ExecuteBackPrime(mCube);
-      break;
-   case eCubeMove::Back2:
-      ExecuteBack2(mCube);
-      break;
-   case eCubeMove::UpWide:
-      ExecuteUpWide(mCube);
-      break;
-   case eCubeMove::UpWidePrime:
-      ExecuteUpWidePrime(mCube);
-      break;
-   case eCubeMove::UpWide2:
-      ExecuteUpWide2(mCube);
-      break;
-   case eCubeMove::DownWide:
-      ExecuteDownWide(mCube);
-      break;
-   case eCubeMove::DownWidePrime:
-      ExecuteDownWidePrime(mCube);
-      break;
-   case eCubeMove::DownWide2:
-      ExecuteDownWide2(mCube);
-      break;
-   case eCubeMove::RightWide:
-      ExecuteRightWide(mCube);
-      break;
-   case eCubeMove::RightWidePrime:
-      ExecuteRightWidePrime(mCube);
-      break;
-   case eCubeMove::RightWide2:
-      ExecuteRightWide2(mCube);
-      break;
-   case eCubeMove::LeftWide:
-      ExecuteLeftWide(mCube);
-      break;
-   case eCubeMove::LeftWidePrime:
-      ExecuteLeftWidePrime(mCube);
-      break;
-   case eCubeMove::LeftWide2:
-      ExecuteLeftWide2(mCube);
-      break;
-   case eCubeMove::FrontWide:
-      ExecuteFrontWide(mCube);
-      break;
-   case eCubeMove::FrontWidePrime:
-      ExecuteFrontWidePrime(mCube);
-      break;
-   case eCubeMove::FrontWide2:
-      ExecuteFrontWide2(mCube);
-      break;
-   case eCubeMove::BackWide:
-      ExecuteBackWide(mCube);
-      break;
-   case eCubeMove::BackWidePrime:
-      ExecuteBackWidePrime(mCube);
-      break;
-   case eCubeMove::BackWide2:
-      ExecuteBackWide2(mCube);
-      break;
-   case eCubeMove::Middle:
-      ExecuteMiddle(mCube);
-      break;
-   case eCubeMove::MiddlePrime:
-      ExecuteMiddlePrime(mCube);
-      break;
-   case eCubeMove::Middle2:
-      ExecuteMiddle2(mCube);
-      break;
-   case eCubeMove::Equator:
-      ExecuteEquator(mCube);
-      break;
-   case eCubeMove::EquatorPrime:
-      ExecuteEquatorPrime(mCube);
-      break;
-   case eCubeMove::Equator2:
-      ExecuteEquator2(mCube);
-      break;
-   case eCubeMove::Standing:
-      ExecuteStanding(mCube);
-      break;
-   case eCubeMove::StandingPrime:
-      ExecuteStandingPrime(mCube);
-      break;
-   case eCubeMove::Standing2:
-      ExecuteStanding2(mCube);
-      break;
-   case eCubeMove::X:
-      ExecuteX(mCube);
-      break;
-   case eCubeMove::XPrime:
-      ExecuteXPrime(mCube);
-      break;
-   case eCubeMove::X2:
-      ExecuteX2(mCube);
-      break;
-   case eCubeMove::Y:
-      ExecuteY(mCube);
-      break;
-   case eCubeMove::YPrime:
-      ExecuteYPrime(mCube);
-      break;
-   case eCubeMove::Y2:
-      ExecuteY2(mCube);
-      break;
-   case eCubeMove::Z:
-      ExecuteZ(mCube);
-      break;
-   case eCubeMove::ZPrime:
-      ExecuteZPrime(mCube);
-      break;
-   case eCubeMove::Z2:
-      ExecuteZ2(mCube);
-      break;
-   default:
-      std::cout << "Invalid move " << EnumToInt(move) << "\n";
-      break;
+   // Below this, starting threads costs more than executing the moves.
+   constexpr size_t minMovesPerThread = 1 << 16;
+
+   if (numThreads == 0)
+   {
+      numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+   }
+
+   size_t numChunks = std::min<size_t>(numThreads, numMoves / minMovesPerThread);
+   if (numChunks <= 1)
+   {
+      ExecuteMoves(moves, numMoves);
+      return;
+   }
+
+   // Every chunk is reduced independently. Composing permutations is associative, so the chunks
+   // only need to be combined in order.
+   std::vector<CompiledAlgorithm> chunks(numChunks);
+   std::vector<std::thread> threads;
+   threads.reserve(numChunks);
+
+   size_t chunkSize = numMoves / numChunks;
+   for (size_t i = 0; i < numChunks; i++)
+   {
+      size_t begin = i * chunkSize;
+      size_t end = i == numChunks - 1 ? numMoves : begin + chunkSize;
+      threads.emplace_back([&chunks, moves, i, begin, end]()
+      {
+         chunks[i] = CompiledAlgorithm(moves + begin, end - begin, false);
+      });
+   }
+
+   for (auto& thread : threads)
+   {
+      thread.join();
+   }
+
+   // Pairwise tree reduction, chunk i absorbs chunk i + stride.
+   for (size_t stride = 1; stride < numChunks; stride *= 2)
+   {
+      for (size_t i = 0; i + stride < numChunks; i += stride * 2)
+      {
+         chunks[i].Append(chunks[i + stride]);
+      }
    }
+
+   ExecuteAlgorithm(chunks[0]);
 }
 
 void PrintRow(SingleCubeFace& face, int row, std::ostream& outputStream, bool useColor)
@@ -941,7 +1436,10 @@ void PrintRow(SingleCubeFace& face, int row, std::ostream& outputStream, bool us
 
 void Cube::PrintFace(eCubeFace faceToken, std::ostream& outputStream, bool useColor)
 {
-   SingleCubeFace& face = mCube[EnumToInt(faceToken)];
+   CubeFaceData faceData;
+   CopyFaceData(faceData);
+
+   SingleCubeFace& face = faceData[EnumToInt(faceToken)];
    for (int j = 0; j < CubeSize; j++)
    {
       PrintRow(face, j, outputStream, useColor);
@@ -951,317 +1449,140 @@ void Cube::PrintFace(eCubeFace faceToken, std::ostream& outputStream, bool useCo
 
 void Cube::Print(std::ostream& outputStream, bool useColor)
 {
+   CubeFaceData faceData;
+   CopyFaceData(faceData);
+
    for (int i = 0; i < CubeSize; i++)
    {
-      PrintRow(mCube[EnumToInt(eCubeFace::Front)], i, outputStream, useColor);
+      PrintRow(faceData[EnumToInt(eCubeFace::Front)], i, outputStream, useColor);
       outputStream << "    ";
-      PrintRow(mCube[EnumToInt(eCubeFace::Top)], i, outputStream, useColor);
+      PrintRow(faceData[EnumToInt(eCubeFace::Top)], i, outputStream, useColor);
       outputStream << "    ";
-      PrintRow(mCube[EnumToInt(eCubeFace::Left)], i, outputStream, useColor);
+      PrintRow(faceData[EnumToInt(eCubeFace::Left)], i, outputStream, useColor);
       outputStream << "    ";
-      PrintRow(mCube[EnumToInt(eCubeFace::Right)], i, outputStream, useColor);
+      PrintRow(faceData[EnumToInt(eCubeFace::Right)], i, outputStream, useColor);
       outputStream << "    ";
-      PrintRow(mCube[EnumToInt(eCubeFace::Bottom)], i, outputStream, useColor);
+      PrintRow(faceData[EnumToInt(eCubeFace::Bottom)], i, outputStream, useColor);
       outputStream << "    ";
-      PrintRow(mCube[EnumToInt(eCubeFace::Back)], i, outputStream, useColor);
+      PrintRow(faceData[EnumToInt(eCubeFace::Back)], i, outputStream, useColor);
       outputStream << "\n";
    }
    outputStream << "Front     Top       Left      Right     Bottom    Back      \n";
 }
 
-class MoveMaps
+tNotationResult Cube::ParseMoveNotation(
+   std::string_view moveNotation, std::vector<eCubeMove>& moves)
 {
-public:
-   static const std::map<std::string, eCubeMove>& GetNotationToMoveMap()
-   {
-      static const std::map<std::string, eCubeMove> notationToMoveMap = []()
-      {
-         std::map<std::string, eCubeMove> result =
-         {
-            // Standard
-            { "U", eCubeMove::Up },
-            { "D", eCubeMove::Down },
-            { "R", eCubeMove::Right },
-            { "L", eCubeMove::Left },
-            { "F", eCubeMove::Front },
-            { "B", eCubeMove::Back },
-
-            { "U'", eCubeMove::UpPrime },
-            { "D'", eCubeMove::DownPrime },
-            { "R'", eCubeMove::RightPrime },
-            { "L'", eCubeMove::LeftPrime },
-            { "F'", eCubeMove::FrontPrime },
-            { "B'", eCubeMove::BackPrime },
-
-            { "U2", eCubeMove::Up2 },
-            { "D2", eCubeMove::Down2 },
-            { "R2", eCubeMove::Right2 },
-            { "L2", eCubeMove::Left2 },
-            { "F2", eCubeMove::Front2 },
-            { "B2", eCubeMove::Back2 },
-
-            // Wide
-            { "Uw", eCubeMove::UpWide },
-            { "Dw", eCubeMove::DownWide },
-            { "Rw", eCubeMove::RightWide },
-            { "Lw", eCubeMove::LeftWide },
-            { "Fw", eCubeMove::FrontWide },
-            { "Bw", eCubeMove::BackWide },
-            { "u", eCubeMove::UpWide },
-            { "d", eCubeMove::DownWide },
-            { "r", eCubeMove::RightWide },
-            { "l", eCubeMove::LeftWide },
-            { "f", eCubeMove::FrontWide },
-            { "b", eCubeMove::BackWide },
-
-            { "Uw'", eCubeMove::UpWidePrime },
-            { "Dw'", eCubeMove::DownWidePrime },
-            { "Rw'", eCubeMove::RightWidePrime },
-            { "Lw'", eCubeMove::LeftWidePrime },
-            { "Fw'", eCubeMove::FrontWidePrime },
-            { "Bw'", eCubeMove::BackWidePrime },
-            { "u'", eCubeMove::UpWidePrime },
-            { "d'", eCubeMove::DownWidePrime },
-            { "r'", eCubeMove::RightWidePrime },
-            { "l'", eCubeMove::LeftWidePrime },
-            { "f'", eCubeMove::FrontWidePrime },
-            { "b'", eCubeMove::BackWidePrime },
-
-            { "Uw2", eCubeMove::UpWide2 },
-            { "Dw2", eCubeMove::DownWide2 },
-            { "Rw2", eCubeMove::RightWide2 },
-            { "Lw2", eCubeMove::LeftWide2 },
-            { "Fw2", eCubeMove::FrontWide2 },
-            { "Bw2", eCubeMove::BackWide2 },
-            { "u2", eCubeMove::UpWide2 },
-            { "d2", eCubeMove::DownWide2 },
-            { "r2", eCubeMove::RightWide2 },
-            { "l2", eCubeMove::LeftWide2 },
-            { "f2", eCubeMove::FrontWide2 },
-            { "b2", eCubeMove::BackWide2 },
-
-            // Cube rotations
-            { "x", eCubeMove::X },
-            { "y", eCubeMove::Y },
-            { "z", eCubeMove::Z },
-
-            { "x'", eCubeMove::XPrime },
-            { "y'", eCubeMove::YPrime },
-            { "z'", eCubeMove::ZPrime },
-
-            { "x2", eCubeMove::X2 },
-            { "y2", eCubeMove::Y2 },
-            { "z2", eCubeMove::Z2 },
-
-            // Slice moves
-            { "M", eCubeMove::Middle },
-            { "E", eCubeMove::Equator },
-            { "S", eCubeMove::Standing },
-
-            { "M'", eCubeMove::MiddlePrime },
-            { "E'", eCubeMove::EquatorPrime },
-            { "S'", eCubeMove::StandingPrime },
-
-            { "M2", eCubeMove::Middle2 },
-            { "E2", eCubeMove::Equator2 },
-            { "S2", eCubeMove::Standing2 },
-         };
-
-         return result;
-      }();
-
-      return notationToMoveMap;
-   }
-
-   static const std::map<eCubeMove, std::string>& GetMoveToNotationMap()
-   {
-      static const std::map<eCubeMove, std::string>& moveToNotationMap = []()
-      {
-         // Init valid chars set and setup the default notations.
-         std::map<eCubeMove, std::string> moveToNotationMap;
-         for (auto kvp : GetNotationToMoveMap())
-         {
-            // Now set the mapping to notation if it's not already set.
-            if (!moveToNotationMap.contains(kvp.second))
-            {
-               moveToNotationMap.emplace(kvp.second, kvp.first);
-            }
-         }
-
-         return moveToNotationMap;
-      }();
-
-      return moveToNotationMap;
-   }
+   size_t start = moves.size();
+   moves.resize(start + GetMaxNotationMoves(moveNotation.size()));
+   std::span<eCubeMove> buffer(moves.begin() + start, moves.end());
 
-   static const std::unordered_set<char>& GetValidChars()
+   tNotationResult total = {};
+   size_t notationOffset = 0;
+   while (true)
    {
-      static const std::unordered_set<char> validChars = []()
+      tNotationResult result = cube::ParseMoveNotation(moveNotation, buffer);
+      buffer = buffer.subspan(result.NumMoves);
+      total.NumMoves += result.NumMoves;
+      if (result.Error == eNotationError::None)
       {
-         // Init valid chars set and setup the default notations.
-         std::unordered_set<char> validChars;
-         for (auto kvp : GetNotationToMoveMap())
-         {
-            for (int i = 0; i < kvp.first.size(); i++)
-            {
-               if (!validChars.contains(kvp.first[i]))
-               {
-                  validChars.emplace(kvp.first[i]);
-               }
-            }
-         }
-
-         return validChars;
-      }();
+         break;
+      }
 
-      return validChars;
-   }
-};
+      // The buffer always fits, only invalid moves stop the parser. Skip them and go on.
+      assert(result.Error == eNotationError::InvalidMove && "Notation buffer is too small.");
+      if (total.NumSkippedMoves++ == 0)
+      {
+         total.Error = result.Error;
+         total.ErrorOffset = notationOffset + result.ErrorOffset;
+         total.ErrorLength = result.ErrorLength;
+      }
 
-static bool AddMove(const std::string& currentToken, std::vector<eCubeMove>& moves)
-{
-   auto moveToken = MoveMaps::GetNotationToMoveMap().find(currentToken);
-   if (moveToken != MoveMaps::GetNotationToMoveMap().end())
-   {
-      moves.push_back(moveToken->second);
-      return true;
+      notationOffset += result.ErrorOffset + result.ErrorLength;
+      moveNotation.remove_prefix(result.ErrorOffset + result.ErrorLength);
    }
 
-   return false;
+   moves.resize(moves.size() - buffer.size());
+   return total;
 }
 
-void Cube::ParseMoveNotation(const std::string& moveNotation, std::vector<eCubeMove>& moves)
+tNotationResult Cube::ParseMoveNotation(std::string_view moveNotation, std::span<eCubeMove> moves)
 {
-   std::string currentToken;
-   for (int i = 0; i < moveNotation.size(); i++)
-   {
-      if (MoveMaps::GetValidChars().contains(moveNotation[i]))
-      {
-         currentToken += moveNotation[i];
-      }
-      else
-      {
-         if (currentToken.size() > 0)
-         {
-            if (!AddMove(currentToken, moves))
-            {
-               std::cout << "Invalid move in string: " << currentToken << "\n";
-            }
+   return cube::ParseMoveNotation(moveNotation, moves);
+}
 
-            currentToken.clear();
-         }
-      }
-   }
+void Cube::SerializeMoveList(
+   std::ostream& outputStream, const eCubeMove* moves, size_t numMoves, bool includeSeparators)
+{
+   // Whole groups of moves per block, so the separators line up across blocks.
+   constexpr size_t blockMoves = 64 * MovesPerSeparator;
+   std::array<char, GetMaxSerializedLength(blockMoves)> buffer;
 
-   if (currentToken.size() > 0)
+   for (size_t i = 0; i < numMoves; i += blockMoves)
    {
-      if (!AddMove(currentToken, moves))
+      std::span<const eCubeMove> block(moves + i, std::min(blockMoves, numMoves - i));
+      if (includeSeparators && i > 0)
       {
-         std::cout << "Invalid move in string: " << currentToken << "\n";
+         outputStream << MoveSeparator;
       }
+
+      size_t length = cube::SerializeMoveList(block, buffer, includeSeparators);
+      outputStream.write(buffer.data(), static_cast<std::streamsize>(length));
    }
 }
 
-void Cube::SerializeMoveList(std::ostream& outputStream, eCubeMove *moves, size_t numMoves, bool includeSeparators)
+size_t Cube::SerializeMoveList(
+   std::span<const eCubeMove> moves, std::span<char> buffer, bool includeSeparators)
 {
-   constexpr int separatorDist = 5;
-   int separatorIdx = 0;
+   return cube::SerializeMoveList(moves, buffer, includeSeparators);
+}
 
-   for (size_t i = 0; i < numMoves; i++)
+void Cube::ReverseMoves(const std::vector<eCubeMove>& moves, std::vector<eCubeMove>& reverseMoves)
+{
+   reverseMoves.reserve(reverseMoves.size() + moves.size());
+   for (size_t i = moves.size(); i-- > 0;)
    {
-      // Add the separator if necessary
-      if (separatorIdx >= separatorDist)
+      if (EnumToInt(moves[i]) < NumMoves)
       {
-         separatorIdx = 0;
-         outputStream << "- ";
+         reverseMoves.push_back(GetInverseMove(moves[i]));
       }
-
-      auto move = MoveMaps::GetMoveToNotationMap().find(moves[i]);
-
-      if (move != MoveMaps::GetMoveToNotationMap().end())
-      {
-         outputStream << move->second << " ";
-      }
-      else 
+      else
       {
-         // Error case.
-         outputStream << "?? ";
+         std::cout << "Invalid move to reverse: " << EnumToInt(moves[i]) << "\n";
       }
-
-      separatorIdx++;
    }
 }
 
-void Cube::ReverseMoves(const std::vector<eCubeMove>& moves, std::vector<eCubeMove>& reverseMoves)
+void Cube::GenerateScramble(std::vector<eCubeMove>& scramble, int numMoves, int seed)
 {
-   static std::map<eCubeMove, eCubeMove> reverseMap
-   {
-      { eCubeMove::Up, eCubeMove::UpPrime },
-      { eCubeMove::UpPrime, eCubeMove::Up },
-      { eCubeMove::Up2, eCubeMove::Up2 },
-      { eCubeMove::Down, eCubeMove::DownPrime },
-      { eCubeMove::DownPrime, eCubeMove::Down },
-      { eCubeMove::Down2, eCubeMove::Down2 },
-      { eCubeMove::Right, eCubeMove::RightPrime },
-      { eCubeMove::RightPrime, eCubeMove::Right },
-      { eCubeMove::Right2, eCubeMove::Right2 },
-      { eCubeMove::Left, eCubeMove::LeftPrime },
-      { eCubeMove::LeftPrime, eCubeMove::Left },
-      { eCubeMove::Left2, eCubeMove::Left2 },
-      { eCubeMove::Front, eCubeMove::FrontPrime },
-      { eCubeMove::FrontPrime, eCubeMove::Front },
-      { eCubeMove::Front2, eCubeMove::Front2 },
-      { eCubeMove::Back, eCubeMove::BackPrime },
-      { eCubeMove::BackPrime, eCubeMove::Back },
-      { eCubeMove::Back2, eCubeMove::Back2 },
-      { eCubeMove::UpWide, eCubeMove::UpWidePrime },
-      { eCubeMove::UpWidePrime, eCubeMove::UpWide },
-      { eCubeMove::UpWide2, eCubeMove::UpWide2 },
-      { eCubeMove::DownWide, eCubeMove::DownWidePrime },
-      { eCubeMove::DownWidePrime, eCubeMove::DownWide },
-      { eCubeMove::DownWide2, eCubeMove::DownWide2 },
-      { eCubeMove::RightWide, eCubeMove::RightWidePrime },
-      { eCubeMove::RightWidePrime, eCubeMove::RightWide },
-      { eCubeMove::RightWide2, eCubeMove::RightWide2 },
-      { eCubeMove::LeftWide, eCubeMove::LeftWidePrime },
-      { eCubeMove::LeftWidePrime, eCubeMove::LeftWide },
-      { eCubeMove::LeftWide2, eCubeMove::LeftWide2 },
-      { eCubeMove::FrontWide, eCubeMove::FrontWidePrime },
-      { eCubeMove::FrontWidePrime, eCubeMove::FrontWide },
-      { eCubeMove::FrontWide2, eCubeMove::FrontWide2 },
-      { eCubeMove::BackWide, eCubeMove::BackWidePrime },
-      { eCubeMove::BackWidePrime, eCubeMove::BackWide },
-      { eCubeMove::BackWide2, eCubeMove::BackWide2 },
-      { eCubeMove::Middle, eCubeMove::MiddlePrime },
-      { eCubeMove::MiddlePrime, eCubeMove::Middle },
-      { eCubeMove::Middle2, eCubeMove::Middle2 },
-      { eCubeMove::Equator, eCubeMove::EquatorPrime },
-      { eCubeMove::EquatorPrime, eCubeMove::Equator },
-      { eCubeMove::Equator2, eCubeMove::Equator2 },
-      { eCubeMove::Standing, eCubeMove::StandingPrime },
-      { eCubeMove::StandingPrime, eCubeMove::Standing },
-      { eCubeMove::Standing2, eCubeMove::Standing2 },
-      { eCubeMove::X, eCubeMove::XPrime },
-      { eCubeMove::XPrime, eCubeMove::X},
-      { eCubeMove::X2, eCubeMove::X2 },
-      { eCubeMove::Y, eCubeMove::YPrime },
-      { eCubeMove::YPrime, eCubeMove::Y },
-      { eCubeMove::Y2, eCubeMove::Y2 },
-      { eCubeMove::Z, eCubeMove::ZPrime },
-      { eCubeMove::ZPrime, eCubeMove::Z },
-      { eCubeMove::Z2, eCubeMove::Z2 },
+   std::random_device rd;
+   std::mt19937 engine(rd());
+   engine.seed(seed);
+
+   // Define the valid moves for a scramble
+   static constexpr std::array<eCubeMove, 12> validScrambleMoves
+   {
+      eCubeMove::Right, eCubeMove::Right2, eCubeMove::RightPrime,
+      eCubeMove::Left, eCubeMove::Left2, eCubeMove::LeftPrime,
+      eCubeMove::Up, eCubeMove::Up2, eCubeMove::UpPrime,
+      eCubeMove::Front, eCubeMove::Front2, eCubeMove::FrontPrime,
    };
 
-   for (int i = moves.size() - 1; i >= 0; i--)
+   // Uniform integer distribution between 1 and 6 (like a die roll)
+   std::uniform_int_distribution<int> randomMovesGen(0, validScrambleMoves.size() - 1);
+
+   // Generate random sequence of moves, never turning the same face twice in a row.
+   eCubeFace lastFace = eCubeFace::NumFaces;
+   scramble.reserve(scramble.size() + numMoves);
+   while (scramble.size() < numMoves)
    {
-      auto reversedMove = reverseMap.find(moves[i]);
-      if (reversedMove != reverseMap.end())
-      {
-         reverseMoves.push_back(reversedMove->second);
-      }
-      else
+      eCubeMove move = validScrambleMoves[randomMovesGen(engine)];
+      eCubeFace moveFace = GetMoveInfo(move).Face;
+
+      if (moveFace != lastFace)
       {
-         std::cout << "Invalid move to reverse: " << EnumToInt(moves[i]) << "\n";
+         scramble.push_back(move);
+         lastFace = moveFace;
       }
    }
 }
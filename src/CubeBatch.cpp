@@ -0,0 +1,229 @@
+#include "CubeBatch.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstring>
+
+namespace cube
+{
+constexpr int NumFaces = EnumToInt(eCubeFace::NumFaces);
+constexpr int FaceStickers = CubeSize * CubeSize;
+
+// Rows are padded to a multiple of this many cubes to keep them aligned for vector loops.
+constexpr size_t RowAlignment = 64;
+
+/**
+ * @brief      The rows changed by one move. Row Dst[i] receives what was in row Src[i].
+ */
+struct tBatchMoveKernel
+{
+   std::array<uint8_t, CubeBatch::NumStickers> Dst;
+   std::array<uint8_t, CubeBatch::NumStickers> Src;
+   int NumChanged;
+};
+
+using BatchMoveKernels = std::array<tBatchMoveKernel, EnumToInt(eCubeMove::NumMoves)>;
+
+/**
+ * @brief      Builds the kernel of a move by running it on a Cube where every sticker holds its
+ * own position instead of a color, then reading back where each sticker came from.
+ */
+static tBatchMoveKernel BuildKernel(eCubeMove move)
+{
+   Cube labeledCube;
+   for (int sticker = 0; sticker < CubeBatch::NumStickers; sticker++)
+   {
+      labeledCube.SetState(static_cast<eCubeFace>(sticker / FaceStickers),
+         sticker % FaceStickers % CubeSize, sticker % FaceStickers / CubeSize,
+         static_cast<eCubeColor>(sticker));
+   }
+
+   labeledCube.ExecuteMove(move);
+
+   tBatchMoveKernel kernel = {};
+   for (int sticker = 0; sticker < CubeBatch::NumStickers; sticker++)
+   {
+      int src = EnumToInt(labeledCube.GetState(static_cast<eCubeFace>(sticker / FaceStickers),
+         sticker % FaceStickers % CubeSize, sticker % FaceStickers / CubeSize));
+      if (src != sticker)
+      {
+         kernel.Dst[kernel.NumChanged] = static_cast<uint8_t>(sticker);
+         kernel.Src[kernel.NumChanged] = static_cast<uint8_t>(src);
+         kernel.NumChanged++;
+      }
+   }
+
+   return kernel;
+}
+
+static const BatchMoveKernels& GetBatchMoveKernels()
+{
+   static const BatchMoveKernels kernels = []()
+   {
+      BatchMoveKernels result;
+      for (int i = 0; i < EnumToInt(eCubeMove::NumMoves); i++)
+      {
+         result[i] = BuildKernel(static_cast<eCubeMove>(i));
+      }
+
+      return result;
+   }();
+
+   return kernels;
+}
+
+CubeBatch::CubeBatch(size_t numCubes)
+   : mNumCubes(numCubes),
+     mRowStride((numCubes + RowAlignment - 1) / RowAlignment * RowAlignment),
+     mStickers(NumStickers * mRowStride),
+     mScratch(NumStickers * mRowStride)
+{
+   SetSolved();
+}
+
+void CubeBatch::SetSolved()
+{
+   for (int sticker = 0; sticker < NumStickers; sticker++)
+   {
+      eCubeColor color = Cube::DefaultColorOfFace(static_cast<eCubeFace>(sticker / FaceStickers));
+      std::memset(GetRow(sticker), EnumToInt(color), mRowStride);
+   }
+}
+
+void CubeBatch::SetCube(size_t index, const Cube& cube)
+{
+   assert(index < mNumCubes && "Cube index out of range.");
+   for (int sticker = 0; sticker < NumStickers; sticker++)
+   {
+      GetRow(sticker)[index] = cube.GetState(static_cast<eCubeFace>(sticker / FaceStickers),
+         sticker % FaceStickers % CubeSize, sticker % FaceStickers / CubeSize);
+   }
+}
+
+void CubeBatch::GetCube(size_t index, Cube& cube) const
+{
+   assert(index < mNumCubes && "Cube index out of range.");
+
+   CubeFaceData faceData = {};
+   for (int sticker = 0; sticker < NumStickers; sticker++)
+   {
+      faceData[sticker / FaceStickers][sticker % FaceStickers] = GetRow(sticker)[index];
+   }
+
+   cube.SetFaceData(faceData);
+}
+
+void CubeBatch::CheckValidity(std::vector<eCubeValidity>& results) const
+{
+   results.assign(mNumCubes, eCubeValidity::Valid);
+
+   // Count every color over the whole batch with row wide adds, 9 stickers of each is required.
+   std::vector<uint8_t> colorCounts(mNumCubes);
+   for (int color = 0; color < EnumToInt(eCubeColor::NumColors); color++)
+   {
+      std::fill(colorCounts.begin(), colorCounts.end(), 0);
+      for (int sticker = 0; sticker < NumStickers; sticker++)
+      {
+         const eCubeColor* row = GetRow(sticker);
+         for (size_t i = 0; i < mNumCubes; i++)
+         {
+            colorCounts[i] += static_cast<uint8_t>(EnumToInt(row[i]) == color);
+         }
+      }
+
+      for (size_t i = 0; i < mNumCubes; i++)
+      {
+         if (colorCounts[i] != FaceStickers)
+         {
+            results[i] = eCubeValidity::InvalidColors;
+         }
+      }
+   }
+
+   for (size_t i = 0; i < mNumCubes; i++)
+   {
+      if (results[i] != eCubeValidity::Valid)
+      {
+         continue;
+      }
+
+      CubeFaceData faceData = {};
+      for (int sticker = 0; sticker < NumStickers; sticker++)
+      {
+         faceData[sticker / FaceStickers][sticker % FaceStickers] = GetRow(sticker)[i];
+      }
+
+      results[i] = Cube::CheckValidity(faceData);
+   }
+}
+
+void CubeBatch::ExecuteMove(eCubeMove move)
+{
+   assert(EnumToInt(move) < EnumToInt(eCubeMove::NumMoves) && "Invalid move");
+   const tBatchMoveKernel& kernel = GetBatchMoveKernels()[EnumToInt(move)];
+
+   // Gather every row that moves before scattering, the sources overlap the destinations.
+   for (int i = 0; i < kernel.NumChanged; i++)
+   {
+      std::memcpy(mScratch.data() + i * mRowStride, GetRow(kernel.Src[i]), mRowStride);
+   }
+
+   for (int i = 0; i < kernel.NumChanged; i++)
+   {
+      std::memcpy(GetRow(kernel.Dst[i]), mScratch.data() + i * mRowStride, mRowStride);
+   }
+}
+
+void CubeBatch::ExecuteMoves(const eCubeMove* moves, size_t numMoves)
+{
+   for (size_t i = 0; i < numMoves; i++)
+   {
+      ExecuteMove(moves[i]);
+   }
+}
+
+void CubeBatch::AndFaceMatches(
+   eCubeFace face, const eCubeColor* reference, std::vector<uint8_t>& results) const
+{
+   uint8_t* result = results.data();
+   for (int idx = 0; idx < FaceStickers; idx++)
+   {
+      const eCubeColor* row = GetRow(EnumToInt(face) * FaceStickers + idx);
+      for (size_t i = 0; i < mNumCubes; i++)
+      {
+         result[i] &= static_cast<uint8_t>(row[i] == reference[i]);
+      }
+   }
+}
+
+void CubeBatch::IsSolved(std::vector<uint8_t>& results) const
+{
+   results.assign(mNumCubes, 1);
+   for (int face = 0; face < NumFaces; face++)
+   {
+      eCubeFace faceToken = static_cast<eCubeFace>(face);
+      AndFaceMatches(faceToken, GetRow(StickerOf(faceToken, CubeSize / 2, CubeSize / 2)), results);
+   }
+}
+
+void CubeBatch::IsFaceSolved(eCubeFace face, std::vector<uint8_t>& results) const
+{
+   results.assign(mNumCubes, 1);
+   AndFaceMatches(face, GetRow(StickerOf(face, CubeSize / 2, CubeSize / 2)), results);
+}
+
+void CubeBatch::IsFaceColor(eCubeFace face, eCubeColor color, std::vector<uint8_t>& results) const
+{
+   results.assign(mNumCubes, 1);
+   uint8_t* result = results.data();
+   for (int idx = 0; idx < FaceStickers; idx++)
+   {
+      const eCubeColor* row = GetRow(EnumToInt(face) * FaceStickers + idx);
+      for (size_t i = 0; i < mNumCubes; i++)
+      {
+         result[i] &= static_cast<uint8_t>(row[i] == color);
+      }
+   }
+}
+}   // namespace cube
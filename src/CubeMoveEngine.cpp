@@ -0,0 +1,299 @@
+#include "CubeMoveEngine.hpp"
+
+#include <cassert>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define CUBE_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#else
+#define CUBE_X86 0
+#endif
+
+// MSVC allows intrinsics in any function, GCC and Clang have to be told per function.
+#if CUBE_X86 && !defined(_MSC_VER)
+#define CUBE_TARGET_SSSE3 __attribute__((target("ssse3")))
+#else
+#define CUBE_TARGET_SSSE3
+#endif
+
+namespace cube
+{
+constexpr int NumFaces = EnumToInt(eCubeFace::NumFaces);
+constexpr int FaceStickers = CubeSize * CubeSize;
+
+tMoveShuffle BuildMoveShuffle(const CubeFaceData& labeledResult)
+{
+   tMoveShuffle result;
+
+   for (int face = 0; face < NumFaces; face++)
+   {
+      tFaceShuffle& faceShuffle = result.Faces[face];
+      for (auto& mask : faceShuffle.Masks)
+      {
+         mask.fill(tFaceShuffle::ZeroByte);
+      }
+
+      int numSources = 0;
+      for (int idx = 0; idx < FaceStickers; idx++)
+      {
+         int label = EnumToInt(labeledResult[face][idx]);
+         int srcFace = label / FaceStride;
+         int srcIdx = label % FaceStride;
+
+         int source = 0;
+         while (source < numSources && faceShuffle.SrcFaces[source] != srcFace)
+         {
+            source++;
+         }
+
+         if (source == numSources)
+         {
+            assert(source < tFaceShuffle::MaxSources && "Too many source faces.");
+            faceShuffle.SrcFaces[source] = static_cast<uint8_t>(srcFace);
+            numSources++;
+         }
+
+         faceShuffle.Masks[source][idx] = static_cast<uint8_t>(srcIdx);
+      }
+
+      // Unused sources keep their all zero mask, point them anywhere valid.
+      for (int source = numSources; source < tFaceShuffle::MaxSources; source++)
+      {
+         faceShuffle.SrcFaces[source] = faceShuffle.SrcFaces[0];
+      }
+   }
+
+   return result;
+}
+
+tPermutationShuffle BuildPermutationShuffle(const CubeFaceData& labeledResult)
+{
+   tPermutationShuffle result;
+   for (auto& dstMasks : result.Masks)
+   {
+      for (auto& mask : dstMasks)
+      {
+         mask.fill(tFaceShuffle::ZeroByte);
+      }
+   }
+
+   for (int face = 0; face < NumFaces; face++)
+   {
+      for (int idx = 0; idx < FaceStickers; idx++)
+      {
+         int label = EnumToInt(labeledResult[face][idx]);
+         result.Masks[face][label / FaceStride][idx] = static_cast<uint8_t>(label % FaceStride);
+      }
+   }
+
+   return result;
+}
+
+/**
+ * @brief      Fills the lookup table the pattern references point into, see tStickerPattern.
+ */
+static inline void FillReferenceTable(
+   const CubeFaceData& faceData, std::array<uint8_t, FaceStride>& table)
+{
+   for (int face = 0; face < NumFaces; face++)
+   {
+      table[face] = static_cast<uint8_t>(faceData[face][CubeDimsToIdx(CubeSize / 2, CubeSize / 2)]);
+   }
+
+   for (int color = 0; color < FaceStride - tStickerPattern::FixedColors; color++)
+   {
+      table[tStickerPattern::FixedColors + color] = static_cast<uint8_t>(color);
+   }
+}
+
+bool MatchStickerPattern(const CubeFaceData& faceData, const tStickerPattern& pattern)
+{
+   std::array<uint8_t, FaceStride> table = {};
+   FillReferenceTable(faceData, table);
+
+   uint8_t mismatch = 0;
+   for (int face = 0; face < NumFaces; face++)
+   {
+      for (int idx = 0; idx < FaceStride; idx++)
+      {
+         uint8_t expected = table[pattern.References[face][idx] % FaceStride];
+         mismatch |= (static_cast<uint8_t>(faceData[face][idx]) ^ expected) &
+                     pattern.CheckMasks[face][idx];
+      }
+   }
+
+   return mismatch == 0;
+}
+
+bool IsShuffleEngineSupported()
+{
+#if CUBE_X86 && defined(_MSC_VER)
+   int cpuInfo[4];
+   __cpuid(cpuInfo, 1);
+   return (cpuInfo[2] & (1 << 9)) != 0;
+#elif CUBE_X86
+   __builtin_cpu_init();
+   return __builtin_cpu_supports("ssse3");
+#else
+   return false;
+#endif
+}
+
+#if CUBE_X86
+CUBE_TARGET_SSSE3 static inline __m128i ShuffleFace(
+   const CubeFaceData& faceData, const tFaceShuffle& faceShuffle)
+{
+   __m128i first = _mm_shuffle_epi8(
+      _mm_load_si128(reinterpret_cast<const __m128i*>(faceData[faceShuffle.SrcFaces[0]].data())),
+      _mm_load_si128(reinterpret_cast<const __m128i*>(faceShuffle.Masks[0].data())));
+   __m128i second = _mm_shuffle_epi8(
+      _mm_load_si128(reinterpret_cast<const __m128i*>(faceData[faceShuffle.SrcFaces[1]].data())),
+      _mm_load_si128(reinterpret_cast<const __m128i*>(faceShuffle.Masks[1].data())));
+
+   return _mm_or_si128(first, second);
+}
+
+CUBE_TARGET_SSSE3 static inline void StoreFace(SingleCubeFace& face, __m128i value)
+{
+   _mm_store_si128(reinterpret_cast<__m128i*>(face.data()), value);
+}
+
+CUBE_TARGET_SSSE3 void ExecuteMoveShuffle(CubeFaceData& faceData, const tMoveShuffle& shuffle)
+{
+   // Every destination face depends on the old state, build all of them in registers before
+   // storing anything. Sources are loaded straight from the cube, copying it to an indexable local
+   // first costs an extra round trip through the stack.
+   __m128i top = ShuffleFace(faceData, shuffle.Faces[0]);
+   __m128i bottom = ShuffleFace(faceData, shuffle.Faces[1]);
+   __m128i left = ShuffleFace(faceData, shuffle.Faces[2]);
+   __m128i right = ShuffleFace(faceData, shuffle.Faces[3]);
+   __m128i front = ShuffleFace(faceData, shuffle.Faces[4]);
+   __m128i back = ShuffleFace(faceData, shuffle.Faces[5]);
+
+   StoreFace(faceData[0], top);
+   StoreFace(faceData[1], bottom);
+   StoreFace(faceData[2], left);
+   StoreFace(faceData[3], right);
+   StoreFace(faceData[4], front);
+   StoreFace(faceData[5], back);
+}
+
+CUBE_TARGET_SSSE3 static inline __m128i ShuffleLocalFace(
+   const __m128i* faces, const tFaceShuffle& faceShuffle)
+{
+   __m128i first = _mm_shuffle_epi8(faces[faceShuffle.SrcFaces[0]],
+      _mm_load_si128(reinterpret_cast<const __m128i*>(faceShuffle.Masks[0].data())));
+   __m128i second = _mm_shuffle_epi8(faces[faceShuffle.SrcFaces[1]],
+      _mm_load_si128(reinterpret_cast<const __m128i*>(faceShuffle.Masks[1].data())));
+
+   return _mm_or_si128(first, second);
+}
+
+CUBE_TARGET_SSSE3 void ExecuteMoveShuffles(
+   CubeFaceData& faceData, const tMoveShuffle* const* shuffles, size_t numShuffles)
+{
+   __m128i faces[NumFaces];
+   for (int face = 0; face < NumFaces; face++)
+   {
+      faces[face] = _mm_load_si128(reinterpret_cast<const __m128i*>(faceData[face].data()));
+   }
+
+   for (size_t i = 0; i < numShuffles; i++)
+   {
+      // Same as ExecuteMoveShuffle, all the destination faces are built before any is replaced.
+      const tMoveShuffle& shuffle = *shuffles[i];
+      __m128i top = ShuffleLocalFace(faces, shuffle.Faces[0]);
+      __m128i bottom = ShuffleLocalFace(faces, shuffle.Faces[1]);
+      __m128i left = ShuffleLocalFace(faces, shuffle.Faces[2]);
+      __m128i right = ShuffleLocalFace(faces, shuffle.Faces[3]);
+      __m128i front = ShuffleLocalFace(faces, shuffle.Faces[4]);
+      __m128i back = ShuffleLocalFace(faces, shuffle.Faces[5]);
+
+      faces[0] = top;
+      faces[1] = bottom;
+      faces[2] = left;
+      faces[3] = right;
+      faces[4] = front;
+      faces[5] = back;
+   }
+
+   for (int face = 0; face < NumFaces; face++)
+   {
+      StoreFace(faceData[face], faces[face]);
+   }
+}
+
+CUBE_TARGET_SSSE3 void ExecutePermutationShuffle(
+   CubeFaceData& faceData, const tPermutationShuffle& shuffle)
+{
+   __m128i faces[NumFaces];
+   for (int face = 0; face < NumFaces; face++)
+   {
+      faces[face] = _mm_load_si128(reinterpret_cast<const __m128i*>(faceData[face].data()));
+   }
+
+   // A fixed 36 shuffles, no branching on which faces actually contribute.
+   for (int dst = 0; dst < NumFaces; dst++)
+   {
+      __m128i result = _mm_setzero_si128();
+      for (int src = 0; src < NumFaces; src++)
+      {
+         __m128i mask =
+            _mm_load_si128(reinterpret_cast<const __m128i*>(shuffle.Masks[dst][src].data()));
+         result = _mm_or_si128(result, _mm_shuffle_epi8(faces[src], mask));
+      }
+
+      StoreFace(faceData[dst], result);
+   }
+}
+
+CUBE_TARGET_SSSE3 bool MatchStickerPatternShuffle(
+   const CubeFaceData& faceData, const tStickerPattern& pattern)
+{
+   alignas(16) std::array<uint8_t, FaceStride> table = {};
+   FillReferenceTable(faceData, table);
+   __m128i references = _mm_load_si128(reinterpret_cast<const __m128i*>(table.data()));
+
+   // Expected colors come from shuffling the lookup table, mismatching bits are accumulated over
+   // every face and tested once.
+   __m128i mismatch = _mm_setzero_si128();
+   for (int face = 0; face < NumFaces; face++)
+   {
+      __m128i stickers = _mm_load_si128(reinterpret_cast<const __m128i*>(faceData[face].data()));
+      __m128i expected = _mm_shuffle_epi8(references,
+         _mm_load_si128(reinterpret_cast<const __m128i*>(pattern.References[face].data())));
+      __m128i checkMask =
+         _mm_load_si128(reinterpret_cast<const __m128i*>(pattern.CheckMasks[face].data()));
+      mismatch =
+         _mm_or_si128(mismatch, _mm_and_si128(_mm_xor_si128(stickers, expected), checkMask));
+   }
+
+   return _mm_movemask_epi8(_mm_cmpeq_epi8(mismatch, _mm_setzero_si128())) == 0xFFFF;
+}
+#else
+void ExecuteMoveShuffle(CubeFaceData& faceData, const tMoveShuffle& shuffle)
+{
+   assert(false && "Shuffle engine is not supported on this platform.");
+}
+
+void ExecuteMoveShuffles(
+   CubeFaceData& faceData, const tMoveShuffle* const* shuffles, size_t numShuffles)
+{
+   assert(false && "Shuffle engine is not supported on this platform.");
+}
+
+void ExecutePermutationShuffle(CubeFaceData& faceData, const tPermutationShuffle& shuffle)
+{
+   assert(false && "Shuffle engine is not supported on this platform.");
+}
+
+bool MatchStickerPatternShuffle(const CubeFaceData& faceData, const tStickerPattern& pattern)
+{
+   assert(false && "Shuffle engine is not supported on this platform.");
+   return false;
+}
+#endif
+}   // namespace cube
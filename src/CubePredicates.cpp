@@ -0,0 +1,277 @@
+#include "CubePredicates.hpp"
+#include "CubeGeometry.hpp"
+
+#include <array>
+#include <cassert>
+
+namespace cube
+{
+constexpr int NumFaces = EnumToInt(eCubeFace::NumFaces);
+constexpr int FaceStickers = CubeSize * CubeSize;
+constexpr std::array<eCubeFace, 4> SideFaces = {
+   eCubeFace::Left, eCubeFace::Right, eCubeFace::Front, eCubeFace::Back
+};
+
+StickerPredicate::StickerPredicate()
+{
+   for (tStickerPattern& pattern : mPatterns)
+   {
+      for (int face = 0; face < NumFaces; face++)
+      {
+         pattern.References[face].fill(0);
+         pattern.CheckMasks[face].fill(0);
+      }
+   }
+}
+
+void StickerPredicate::SetReference(eCubeFace face, int x, int y, int reference)
+{
+   for (int orientation = 0; orientation < NumOrientations; orientation++)
+   {
+      tStickerPattern& pattern = mPatterns[orientation];
+
+      // Centers are referenced by the face they are stored on.
+      int storedReference = reference;
+      if (reference < tStickerPattern::FixedColors)
+      {
+         storedReference = Cube::GetOrientationSlot(orientation, static_cast<eCubeFace>(reference),
+                              CubeSize / 2, CubeSize / 2) / FaceStride;
+      }
+
+      int slot = Cube::GetOrientationSlot(orientation, face, x, y);
+      assert((pattern.CheckMasks[slot / FaceStride][slot % FaceStride] == 0 ||
+                pattern.References[slot / FaceStride][slot % FaceStride] == storedReference) &&
+             "Conflicting conditions on the same sticker.");
+
+      pattern.References[slot / FaceStride][slot % FaceStride] =
+         static_cast<uint8_t>(storedReference);
+      pattern.CheckMasks[slot / FaceStride][slot % FaceStride] = 0xFF;
+   }
+}
+
+StickerPredicate& StickerPredicate::RequireCenterColor(
+   eCubeFace face, int x, int y, eCubeFace centerFace)
+{
+   SetReference(face, x, y, EnumToInt(centerFace));
+   return *this;
+}
+
+StickerPredicate& StickerPredicate::RequireColor(eCubeFace face, int x, int y, eCubeColor color)
+{
+   SetReference(face, x, y, tStickerPattern::FixedColors + EnumToInt(color));
+   return *this;
+}
+
+StickerPredicate& StickerPredicate::RequireFace(eCubeFace face)
+{
+   for (int idx = 0; idx < FaceStickers; idx++)
+   {
+      RequireCenterColor(face, idx % CubeSize, idx / CubeSize, face);
+   }
+
+   return *this;
+}
+
+StickerPredicate& StickerPredicate::RequirePiece(eCubeFace face1, eCubeFace face2, eCubeFace face3)
+{
+   tVec3 position = GetFaceNormal(face1) + GetFaceNormal(face2);
+   if (face3 != eCubeFace::NumFaces)
+   {
+      position = position + GetFaceNormal(face3);
+   }
+
+   std::array<int, 3> stickers = {};
+   int numStickers = GetPieceStickers(position, stickers);
+   assert(numStickers == (face3 == eCubeFace::NumFaces ? 2 : 3) &&
+          "The faces don't share a piece.");
+
+   for (int i = 0; i < numStickers; i++)
+   {
+      eCubeFace face = static_cast<eCubeFace>(stickers[i] / FaceStickers);
+      int idx = stickers[i] % FaceStickers;
+      RequireCenterColor(face, idx % CubeSize, idx / CubeSize, face);
+   }
+
+   return *this;
+}
+
+bool StickerPredicate::Matches(const Cube& cube) const
+{
+   const tStickerPattern& pattern = mPatterns[cube.GetOrientation()];
+   if (Cube::GetMoveEngine() == eMoveEngine::Shuffle)
+   {
+      return MatchStickerPatternShuffle(cube.GetStoredFaceData(), pattern);
+   }
+
+   return MatchStickerPattern(cube.GetStoredFaceData(), pattern);
+}
+
+void StickerPredicate::Matches(const CubeBatch& batch, std::vector<uint8_t>& results) const
+{
+   const tStickerPattern& pattern = mPatterns[0];
+   size_t numCubes = batch.GetNumCubes();
+   results.assign(numCubes, 1);
+
+   uint8_t* result = results.data();
+   for (int face = 0; face < NumFaces; face++)
+   {
+      for (int idx = 0; idx < FaceStickers; idx++)
+      {
+         if (pattern.CheckMasks[face][idx] == 0)
+         {
+            continue;
+         }
+
+         const eCubeColor* row =
+            batch.GetStickerRow(static_cast<eCubeFace>(face), idx % CubeSize, idx / CubeSize);
+         int referenceIdx = pattern.References[face][idx];
+         if (referenceIdx >= tStickerPattern::FixedColors)
+         {
+            eCubeColor color = static_cast<eCubeColor>(referenceIdx - tStickerPattern::FixedColors);
+            for (size_t i = 0; i < numCubes; i++)
+            {
+               result[i] &= static_cast<uint8_t>(row[i] == color);
+            }
+
+            continue;
+         }
+
+         const eCubeColor* center = batch.GetStickerRow(
+            static_cast<eCubeFace>(referenceIdx), CubeSize / 2, CubeSize / 2);
+         for (size_t i = 0; i < numCubes; i++)
+         {
+            result[i] &= static_cast<uint8_t>(row[i] == center[i]);
+         }
+      }
+   }
+}
+
+const StickerPredicate& StickerPredicate::Solved()
+{
+   static const StickerPredicate predicate = []()
+   {
+      StickerPredicate result;
+      for (int face = 0; face < NumFaces; face++)
+      {
+         result.RequireFace(static_cast<eCubeFace>(face));
+      }
+
+      return result;
+   }();
+
+   return predicate;
+}
+
+const StickerPredicate& StickerPredicate::FaceSolved(eCubeFace face)
+{
+   static const std::array<StickerPredicate, NumFaces> predicates = []()
+   {
+      std::array<StickerPredicate, NumFaces> result;
+      for (int face = 0; face < NumFaces; face++)
+      {
+         result[face].RequireFace(static_cast<eCubeFace>(face));
+      }
+
+      return result;
+   }();
+
+   return predicates[EnumToInt(face)];
+}
+
+const StickerPredicate& StickerPredicate::CrossEdge(eCubeFace sideFace)
+{
+   static const std::array<StickerPredicate, NumFaces> predicates = []()
+   {
+      std::array<StickerPredicate, NumFaces> result;
+      for (eCubeFace face : SideFaces)
+      {
+         result[EnumToInt(face)].RequirePiece(face, eCubeFace::Bottom);
+      }
+
+      return result;
+   }();
+
+   assert(sideFace != eCubeFace::Top && sideFace != eCubeFace::Bottom && "Not a side face.");
+   return predicates[EnumToInt(sideFace)];
+}
+
+const StickerPredicate& StickerPredicate::Cross()
+{
+   static const StickerPredicate predicate = []()
+   {
+      StickerPredicate result;
+      for (eCubeFace face : SideFaces)
+      {
+         result.RequirePiece(face, eCubeFace::Bottom);
+      }
+
+      return result;
+   }();
+
+   return predicate;
+}
+
+/**
+ * @brief      Adds the corner and edge of the F2L pair between two adjacent side faces.
+ */
+static void RequireF2lPair(StickerPredicate& predicate, eCubeFace sideFace1, eCubeFace sideFace2)
+{
+   predicate.RequirePiece(sideFace1, sideFace2);
+   predicate.RequirePiece(sideFace1, sideFace2, eCubeFace::Bottom);
+}
+
+const StickerPredicate& StickerPredicate::F2lPair(eCubeFace sideFace1, eCubeFace sideFace2)
+{
+   static const std::array<std::array<StickerPredicate, NumFaces>, NumFaces> predicates = []()
+   {
+      std::array<std::array<StickerPredicate, NumFaces>, NumFaces> result;
+      for (eCubeFace face1 : { eCubeFace::Left, eCubeFace::Right })
+      {
+         for (eCubeFace face2 : { eCubeFace::Front, eCubeFace::Back })
+         {
+            RequireF2lPair(result[EnumToInt(face1)][EnumToInt(face2)], face1, face2);
+            RequireF2lPair(result[EnumToInt(face2)][EnumToInt(face1)], face1, face2);
+         }
+      }
+
+      return result;
+   }();
+
+   assert(GetFaceNormal(sideFace1).Dot(GetFaceNormal(sideFace2)) == 0 &&
+          GetFaceNormal(sideFace1).Y == 0 && GetFaceNormal(sideFace2).Y == 0 &&
+          "Not two adjacent side faces.");
+   return predicates[EnumToInt(sideFace1)][EnumToInt(sideFace2)];
+}
+
+const StickerPredicate& StickerPredicate::FirstTwoLayers()
+{
+   static const StickerPredicate predicate = []()
+   {
+      StickerPredicate result = Cross();
+      result.RequireFace(eCubeFace::Bottom);
+      for (eCubeFace face1 : { eCubeFace::Left, eCubeFace::Right })
+      {
+         for (eCubeFace face2 : { eCubeFace::Front, eCubeFace::Back })
+         {
+            RequireF2lPair(result, face1, face2);
+         }
+      }
+
+      return result;
+   }();
+
+   return predicate;
+}
+
+const StickerPredicate& StickerPredicate::OrientedLastLayer()
+{
+   static const StickerPredicate predicate = []()
+   {
+      StickerPredicate result = FirstTwoLayers();
+      result.RequireFace(eCubeFace::Top);
+      return result;
+   }();
+
+   return predicate;
+}
+}   // namespace cube
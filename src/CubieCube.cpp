@@ -0,0 +1,496 @@
+#include "CubieCube.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+
+namespace cube
+{
+/**
+ * @brief      A single sticker position on the cube.
+ */
+struct tFacelet
+{
+   eCubeFace Face;
+   uint8_t Idx;
+};
+
+constexpr int NumColors = EnumToInt(eCubeColor::NumColors);
+constexpr uint8_t InvalidPiece = 0xFF;
+constexpr int CenterIdx = CubeDimsToIdx(CubeSize / 2, CubeSize / 2);
+
+// Stickers of each corner slot. The U/D sticker is first, then clockwise around the corner.
+constexpr std::array<std::array<tFacelet, 3>, NumCorners> CornerFacelets = { {
+   { { { eCubeFace::Top, 8 }, { eCubeFace::Right, 0 }, { eCubeFace::Front, 2 } } },       // URF
+   { { { eCubeFace::Top, 6 }, { eCubeFace::Front, 0 }, { eCubeFace::Left, 2 } } },        // UFL
+   { { { eCubeFace::Top, 0 }, { eCubeFace::Left, 0 }, { eCubeFace::Back, 2 } } },         // ULB
+   { { { eCubeFace::Top, 2 }, { eCubeFace::Back, 0 }, { eCubeFace::Right, 2 } } },        // UBR
+   { { { eCubeFace::Bottom, 2 }, { eCubeFace::Front, 8 }, { eCubeFace::Right, 6 } } },    // DFR
+   { { { eCubeFace::Bottom, 0 }, { eCubeFace::Left, 8 }, { eCubeFace::Front, 6 } } },     // DLF
+   { { { eCubeFace::Bottom, 6 }, { eCubeFace::Back, 8 }, { eCubeFace::Left, 6 } } },      // DBL
+   { { { eCubeFace::Bottom, 8 }, { eCubeFace::Right, 8 }, { eCubeFace::Back, 6 } } },     // DRB
+} };
+
+// Stickers of each edge slot. The U/D sticker is first (F/B for the middle layer).
+constexpr std::array<std::array<tFacelet, 2>, NumEdges> EdgeFacelets = { {
+   { { { eCubeFace::Top, 5 }, { eCubeFace::Right, 1 } } },       // UR
+   { { { eCubeFace::Top, 7 }, { eCubeFace::Front, 1 } } },       // UF
+   { { { eCubeFace::Top, 3 }, { eCubeFace::Left, 1 } } },        // UL
+   { { { eCubeFace::Top, 1 }, { eCubeFace::Back, 1 } } },        // UB
+   { { { eCubeFace::Bottom, 5 }, { eCubeFace::Right, 7 } } },    // DR
+   { { { eCubeFace::Bottom, 1 }, { eCubeFace::Front, 7 } } },    // DF
+   { { { eCubeFace::Bottom, 3 }, { eCubeFace::Left, 7 } } },     // DL
+   { { { eCubeFace::Bottom, 7 }, { eCubeFace::Back, 7 } } },     // DB
+   { { { eCubeFace::Front, 5 }, { eCubeFace::Right, 3 } } },     // FR
+   { { { eCubeFace::Front, 3 }, { eCubeFace::Left, 5 } } },      // FL
+   { { { eCubeFace::Back, 5 }, { eCubeFace::Left, 3 } } },       // BL
+   { { { eCubeFace::Back, 3 }, { eCubeFace::Right, 5 } } },      // BR
+} };
+
+[[nodiscard]] static constexpr eCubeColor ColorOfFacelet(const tFacelet& facelet)
+{
+   return Cube::DefaultColorOfFace(facelet.Face);
+}
+
+[[nodiscard]] static constexpr int ColorPairKey(eCubeColor first, eCubeColor second)
+{
+   return EnumToInt(first) * NumColors + EnumToInt(second);
+}
+
+/**
+ * @brief      Maps the two colors following the U/D sticker of a corner (clockwise) to the piece.
+ */
+static constexpr std::array<uint8_t, NumColors * NumColors> CornerLookup = []()
+{
+   std::array<uint8_t, NumColors * NumColors> result = {};
+   for (auto& entry : result)
+   {
+      entry = InvalidPiece;
+   }
+
+   for (int i = 0; i < NumCorners; i++)
+   {
+      eCubeColor color1 = ColorOfFacelet(CornerFacelets[i][1]);
+      eCubeColor color2 = ColorOfFacelet(CornerFacelets[i][2]);
+      result[ColorPairKey(color1, color2)] = static_cast<uint8_t>(i);
+   }
+
+   return result;
+}();
+
+/**
+ * @brief      Maps the two colors of an edge to the piece. The top bit is set if the edge is
+ * flipped.
+ */
+static constexpr std::array<uint8_t, NumColors * NumColors> EdgeLookup = []()
+{
+   std::array<uint8_t, NumColors * NumColors> result = {};
+   for (auto& entry : result)
+   {
+      entry = InvalidPiece;
+   }
+
+   for (int i = 0; i < NumEdges; i++)
+   {
+      eCubeColor color1 = ColorOfFacelet(EdgeFacelets[i][0]);
+      eCubeColor color2 = ColorOfFacelet(EdgeFacelets[i][1]);
+      result[ColorPairKey(color1, color2)] = static_cast<uint8_t>(i);
+      result[ColorPairKey(color2, color1)] = static_cast<uint8_t>(i | 0x80);
+   }
+
+   return result;
+}();
+
+[[nodiscard]] static inline eCubeColor GetFacelet(const CubeFaceData& faceData, const tFacelet& facelet)
+{
+   return faceData[EnumToInt(facelet.Face)][facelet.Idx];
+}
+
+[[nodiscard]] static inline bool IsUpDownColor(eCubeColor color)
+{
+   return color == Cube::DefaultColorOfFace(eCubeFace::Top) ||
+          color == Cube::DefaultColorOfFace(eCubeFace::Bottom);
+}
+
+CubieCube::CubieCube()
+{
+   SetSolved();
+}
+
+CubieCube::CubieCube(const Cube& cube)
+{
+   CubeFaceData faceData;
+   cube.CopyFaceData(faceData);
+
+   bool isValid = FromFaceData(faceData, *this);
+   assert(isValid && "Cube does not hold a valid set of pieces.");
+
+   // Don't keep a half converted state around.
+   if (!isValid)
+   {
+      SetSolved();
+   }
+}
+
+void CubieCube::SetSolved()
+{
+   for (int i = 0; i < NumCorners; i++)
+   {
+      mCornerPerm[i] = static_cast<uint8_t>(i);
+      mCornerTwist[i] = 0;
+   }
+
+   for (int i = 0; i < NumEdges; i++)
+   {
+      mEdgePerm[i] = static_cast<uint8_t>(i);
+      mEdgeFlip[i] = 0;
+   }
+
+   for (int i = 0; i < NumCenters; i++)
+   {
+      mCenters[i] = static_cast<uint8_t>(i);
+   }
+}
+
+bool CubieCube::IsSolved() const
+{
+   return *this == CubieCube();
+}
+
+bool CubieCube::FromFaceData(const CubeFaceData& faceData, CubieCube& result)
+{
+   // Converted into a copy so a failure leaves the result untouched.
+   CubieCube cubies;
+   for (int i = 0; i < NumCenters; i++)
+   {
+      eCubeColor color = faceData[i][CenterIdx];
+      if (EnumToInt(color) >= NumColors)
+      {
+         return false;
+      }
+
+      cubies.mCenters[i] = static_cast<uint8_t>(Cube::DefaultFaceOfColor(color));
+   }
+
+   for (int i = 0; i < NumCorners; i++)
+   {
+      // The twist is the position of the U/D sticker, the other two identify the piece.
+      int twist = 0;
+      while (twist < 3 && !IsUpDownColor(GetFacelet(faceData, CornerFacelets[i][twist])))
+      {
+         twist++;
+      }
+
+      if (twist == 3)
+      {
+         return false;
+      }
+
+      eCubeColor color1 = GetFacelet(faceData, CornerFacelets[i][(twist + 1) % 3]);
+      eCubeColor color2 = GetFacelet(faceData, CornerFacelets[i][(twist + 2) % 3]);
+      if (EnumToInt(color1) >= NumColors || EnumToInt(color2) >= NumColors)
+      {
+         return false;
+      }
+
+      uint8_t piece = CornerLookup[ColorPairKey(color1, color2)];
+      if (piece == InvalidPiece)
+      {
+         return false;
+      }
+
+      // The lookup ignores the U/D color, make sure it's the right one for the piece.
+      if (GetFacelet(faceData, CornerFacelets[i][twist]) != ColorOfFacelet(CornerFacelets[piece][0]))
+      {
+         return false;
+      }
+
+      cubies.mCornerPerm[i] = piece;
+      cubies.mCornerTwist[i] = static_cast<uint8_t>(twist);
+   }
+
+   for (int i = 0; i < NumEdges; i++)
+   {
+      eCubeColor color1 = GetFacelet(faceData, EdgeFacelets[i][0]);
+      eCubeColor color2 = GetFacelet(faceData, EdgeFacelets[i][1]);
+      if (EnumToInt(color1) >= NumColors || EnumToInt(color2) >= NumColors)
+      {
+         return false;
+      }
+
+      uint8_t piece = EdgeLookup[ColorPairKey(color1, color2)];
+      if (piece == InvalidPiece)
+      {
+         return false;
+      }
+
+      cubies.mEdgePerm[i] = piece & 0x7F;
+      cubies.mEdgeFlip[i] = piece >> 7;
+   }
+
+   result = cubies;
+   return true;
+}
+
+void CubieCube::ToFaceData(CubeFaceData& faceData) const
+{
+   faceData = {};
+
+   for (int i = 0; i < NumCenters; i++)
+   {
+      faceData[i][CenterIdx] = Cube::DefaultColorOfFace(static_cast<eCubeFace>(mCenters[i]));
+   }
+
+   for (int i = 0; i < NumCorners; i++)
+   {
+      const auto& pieceFacelets = CornerFacelets[mCornerPerm[i]];
+      for (int j = 0; j < 3; j++)
+      {
+         const tFacelet& facelet = CornerFacelets[i][(j + mCornerTwist[i]) % 3];
+         faceData[EnumToInt(facelet.Face)][facelet.Idx] = ColorOfFacelet(pieceFacelets[j]);
+      }
+   }
+
+   for (int i = 0; i < NumEdges; i++)
+   {
+      const auto& pieceFacelets = EdgeFacelets[mEdgePerm[i]];
+      for (int j = 0; j < 2; j++)
+      {
+         const tFacelet& facelet = EdgeFacelets[i][(j + mEdgeFlip[i]) % 2];
+         faceData[EnumToInt(facelet.Face)][facelet.Idx] = ColorOfFacelet(pieceFacelets[j]);
+      }
+   }
+}
+
+void CubieCube::Unpack(Cube& cube) const
+{
+   CubeFaceData faceData;
+   ToFaceData(faceData);
+   cube.SetFaceData(faceData);
+}
+
+const CubieCube& CubieCube::GetMoveCube(eCubeMove move)
+{
+   static const std::array<CubieCube, EnumToInt(eCubeMove::NumMoves)> moveCubes = []()
+   {
+      // The cubie effect of a move is the state it leaves a solved cube in.
+      std::array<CubieCube, EnumToInt(eCubeMove::NumMoves)> result;
+      for (int i = 0; i < EnumToInt(eCubeMove::NumMoves); i++)
+      {
+         Cube cube;
+         cube.ExecuteMove(static_cast<eCubeMove>(i));
+         result[i] = CubieCube(cube);
+      }
+
+      return result;
+   }();
+
+   return moveCubes[EnumToInt(move)];
+}
+
+void CubieCube::Multiply(const CubieCube& other)
+{
+   CubieCube result;
+
+   for (int i = 0; i < NumCorners; i++)
+   {
+      uint8_t from = other.mCornerPerm[i];
+      result.mCornerPerm[i] = mCornerPerm[from];
+
+      uint8_t twist = mCornerTwist[from] + other.mCornerTwist[i];
+      result.mCornerTwist[i] = twist >= 3 ? twist - 3 : twist;
+   }
+
+   for (int i = 0; i < NumEdges; i++)
+   {
+      uint8_t from = other.mEdgePerm[i];
+      result.mEdgePerm[i] = mEdgePerm[from];
+      result.mEdgeFlip[i] = mEdgeFlip[from] ^ other.mEdgeFlip[i];
+   }
+
+   for (int i = 0; i < NumCenters; i++)
+   {
+      result.mCenters[i] = mCenters[other.mCenters[i]];
+   }
+
+   *this = result;
+}
+
+CubieCube CubieCube::Inverse() const
+{
+   CubieCube result;
+
+   // The piece in slot i goes back to slot i, undoing its twist or flip on the way.
+   for (int i = 0; i < NumCorners; i++)
+   {
+      uint8_t piece = mCornerPerm[i];
+      result.mCornerPerm[piece] = static_cast<uint8_t>(i);
+      result.mCornerTwist[piece] = mCornerTwist[i] == 0 ? 0 : 3 - mCornerTwist[i];
+   }
+
+   for (int i = 0; i < NumEdges; i++)
+   {
+      uint8_t piece = mEdgePerm[i];
+      result.mEdgePerm[piece] = static_cast<uint8_t>(i);
+      result.mEdgeFlip[piece] = mEdgeFlip[i];
+   }
+
+   for (int i = 0; i < NumCenters; i++)
+   {
+      result.mCenters[mCenters[i]] = static_cast<uint8_t>(i);
+   }
+
+   return result;
+}
+
+/**
+ * @return     The parity of the permutation, 1 if odd.
+ */
+template <size_t TSize>
+[[nodiscard]] static int GetPermutationParity(const std::array<uint8_t, TSize>& permutation)
+{
+   // Every cycle of length n is made of n - 1 swaps.
+   uint32_t visited = 0;
+   int parity = 0;
+   for (size_t i = 0; i < TSize; i++)
+   {
+      if (visited & (1u << i))
+      {
+         continue;
+      }
+
+      for (size_t j = i; !(visited & (1u << j)); j = permutation[j])
+      {
+         visited |= 1u << j;
+         parity ^= 1;
+      }
+
+      parity ^= 1;
+   }
+
+   return parity;
+}
+
+/**
+ * @return     The 24 whole cube rotations, as cubie states.
+ */
+static const std::array<CubieCube, NumOrientations>& GetRotationCubes()
+{
+   static const std::array<CubieCube, NumOrientations> rotations = []()
+   {
+      std::array<CubieCube, NumOrientations> result;
+
+      // Quarter turns around two axes reach all of them.
+      int count = 1;
+      for (int i = 0; i < count; i++)
+      {
+         for (eCubeMove move : { eCubeMove::X, eCubeMove::Y })
+         {
+            CubieCube candidate = result[i];
+            candidate.ExecuteMove(move);
+            auto end = result.begin() + count;
+            if (std::find(result.begin(), end, candidate) == end)
+            {
+               result[count++] = candidate;
+            }
+         }
+      }
+
+      assert(count == NumOrientations && "Missing rotations.");
+      return result;
+   }();
+
+   return rotations;
+}
+
+eCubeValidity CubieCube::CheckValidity() const
+{
+   uint32_t seenCorners = 0;
+   int twist = 0;
+   for (int i = 0; i < NumCorners; i++)
+   {
+      seenCorners |= 1u << mCornerPerm[i];
+      twist += mCornerTwist[i];
+   }
+
+   uint32_t seenEdges = 0;
+   int flip = 0;
+   for (int i = 0; i < NumEdges; i++)
+   {
+      seenEdges |= 1u << mEdgePerm[i];
+      flip += mEdgeFlip[i];
+   }
+
+   if (seenCorners != (1u << NumCorners) - 1 || seenEdges != (1u << NumEdges) - 1)
+   {
+      return eCubeValidity::DuplicatePiece;
+   }
+
+   // Slice moves and rotations move the centers, and the twist and parity rules only hold with the
+   // centers home. Undo the rotation that has the same centers, the result is solvable if and
+   // only if this is.
+   const CubieCube* rotation = nullptr;
+   for (const CubieCube& candidate : GetRotationCubes())
+   {
+      if (candidate.mCenters == mCenters)
+      {
+         rotation = &candidate;
+         break;
+      }
+   }
+
+   if (rotation == nullptr)
+   {
+      return eCubeValidity::InvalidCenters;
+   }
+
+   CubieCube homeCenters = *this;
+   if (rotation != &GetRotationCubes()[0])
+   {
+      homeCenters.Multiply(rotation->Inverse());
+      twist = 0;
+      flip = 0;
+      for (int i = 0; i < NumCorners; i++)
+      {
+         twist += homeCenters.mCornerTwist[i];
+      }
+
+      for (int i = 0; i < NumEdges; i++)
+      {
+         flip += homeCenters.mEdgeFlip[i];
+      }
+   }
+
+   if (twist % 3 != 0)
+   {
+      return eCubeValidity::TwistedCorner;
+   }
+
+   if (flip % 2 != 0)
+   {
+      return eCubeValidity::FlippedEdge;
+   }
+
+   if (GetPermutationParity(homeCenters.mCornerPerm) != GetPermutationParity(homeCenters.mEdgePerm))
+   {
+      return eCubeValidity::ParityError;
+   }
+
+   return eCubeValidity::Valid;
+}
+
+void CubieCube::ExecuteMove(eCubeMove move)
+{
+   assert(EnumToInt(move) < EnumToInt(eCubeMove::NumMoves) && "Invalid move");
+   Multiply(GetMoveCube(move));
+}
+
+void CubieCube::ExecuteMoves(const eCubeMove* moves, size_t numMoves)
+{
+   for (size_t i = 0; i < numMoves; i++)
+   {
+      ExecuteMove(moves[i]);
+   }
+}
+}   // namespace cube
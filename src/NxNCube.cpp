@@ -0,0 +1,179 @@
+#include "NxNCube.hpp"
+
+#include <algorithm>
+#include <cctype>
+
+namespace cube
+{
+/**
+ * @brief      The axis a face letter turns around and whether the face is at the positive end of
+ * that axis.
+ */
+static bool GetFaceAxis(char face, eCubeAxis& axis, bool& isPositiveEnd)
+{
+   switch (std::toupper(static_cast<unsigned char>(face)))
+   {
+   case 'U':
+      axis = eCubeAxis::YAxis;
+      isPositiveEnd = true;
+      return true;
+   case 'D':
+      axis = eCubeAxis::YAxis;
+      isPositiveEnd = false;
+      return true;
+   case 'R':
+      axis = eCubeAxis::XAxis;
+      isPositiveEnd = true;
+      return true;
+   case 'L':
+      axis = eCubeAxis::XAxis;
+      isPositiveEnd = false;
+      return true;
+   case 'F':
+      axis = eCubeAxis::ZAxis;
+      isPositiveEnd = true;
+      return true;
+   case 'B':
+      axis = eCubeAxis::ZAxis;
+      isPositiveEnd = false;
+      return true;
+   default:
+      return false;
+   }
+}
+
+bool ParseLayerMove(std::string_view token, int cubeSize, tLayerMove& move)
+{
+   size_t pos = 0;
+   int depth = 0;
+   while (pos < token.size() && std::isdigit(static_cast<unsigned char>(token[pos])))
+   {
+      depth = depth * 10 + (token[pos] - '0');
+      pos++;
+
+      if (depth > cubeSize)
+      {
+         return false;
+      }
+   }
+
+   bool hasDepth = pos > 0;
+   if (pos >= token.size() || (hasDepth && depth == 0))
+   {
+      return false;
+   }
+
+   char letter = token[pos++];
+   eCubeAxis axis;
+   bool isPositiveEnd;
+
+   // Clockwise turn of the face at the given end, see tLayerMove.
+   uint8_t quarterTurns;
+   if (GetFaceAxis(letter, axis, isPositiveEnd))
+   {
+      bool isWide = std::islower(static_cast<unsigned char>(letter));
+      if (!isWide && pos < token.size() && token[pos] == 'w')
+      {
+         isWide = true;
+         pos++;
+      }
+
+      if (!hasDepth)
+      {
+         depth = isWide ? 2 : 1;
+      }
+
+      int nearLayer = isPositiveEnd ? cubeSize - 1 : 0;
+      int depthLayer = isPositiveEnd ? cubeSize - depth : depth - 1;
+      move.Axis = axis;
+      move.FirstLayer = static_cast<uint8_t>(std::min(isWide ? nearLayer : depthLayer, depthLayer));
+      move.LastLayer = static_cast<uint8_t>(std::max(isWide ? nearLayer : depthLayer, depthLayer));
+      quarterTurns = isPositiveEnd ? 3 : 1;
+   }
+   else if (!hasDepth && (letter == 'x' || letter == 'y' || letter == 'z'))
+   {
+      move.Axis = letter == 'x' ? eCubeAxis::XAxis
+                                : (letter == 'y' ? eCubeAxis::YAxis : eCubeAxis::ZAxis);
+      move.FirstLayer = 0;
+      move.LastLayer = static_cast<uint8_t>(cubeSize - 1);
+      quarterTurns = 3;
+   }
+   else if (!hasDepth && cubeSize % 2 == 1 && (letter == 'M' || letter == 'E' || letter == 'S'))
+   {
+      // M follows L, E follows D and S follows F.
+      move.Axis = letter == 'M' ? eCubeAxis::XAxis
+                                : (letter == 'E' ? eCubeAxis::YAxis : eCubeAxis::ZAxis);
+      move.FirstLayer = static_cast<uint8_t>(cubeSize / 2);
+      move.LastLayer = move.FirstLayer;
+      quarterTurns = letter == 'S' ? 3 : 1;
+   }
+   else
+   {
+      return false;
+   }
+
+   std::string_view modifier = token.substr(pos);
+   if (modifier == "'")
+   {
+      quarterTurns = static_cast<uint8_t>((4 - quarterTurns) % 4);
+   }
+   else if (modifier == "2" || modifier == "2'")
+   {
+      quarterTurns = 2;
+   }
+   else if (!modifier.empty())
+   {
+      return false;
+   }
+
+   move.QuarterTurns = quarterTurns;
+   return true;
+}
+
+/**
+ * @return     True if the character can be part of a move, every other character separates moves.
+ */
+static inline bool IsLayerNotationChar(char c)
+{
+   return std::isalnum(static_cast<unsigned char>(c)) || c == '\'';
+}
+
+tNotationResult ParseLayerMoveNotation(
+   std::string_view moveNotation, int cubeSize, std::vector<tLayerMove>& moves)
+{
+   tNotationResult result = {};
+   size_t pos = 0;
+   while (pos < moveNotation.size())
+   {
+      if (!IsLayerNotationChar(moveNotation[pos]))
+      {
+         pos++;
+         continue;
+      }
+
+      size_t start = pos;
+      while (pos < moveNotation.size() && IsLayerNotationChar(moveNotation[pos]))
+      {
+         pos++;
+      }
+
+      tLayerMove move;
+      if (ParseLayerMove(moveNotation.substr(start, pos - start), cubeSize, move))
+      {
+         moves.push_back(move);
+         result.NumMoves++;
+         continue;
+      }
+
+      // Skip invalid moves and go on, the error describes the first one.
+      if (result.NumSkippedMoves++ == 0)
+      {
+         result.Error = eNotationError::InvalidMove;
+         result.ErrorOffset = start;
+         result.ErrorLength = pos - start;
+      }
+   }
+
+   return result;
+}
+}   // namespace cube
@@ -0,0 +1,222 @@
+#include "PackedCube.hpp"
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+
+namespace cube
+{
+constexpr int NumFaces = EnumToInt(eCubeFace::NumFaces);
+constexpr int FaceStickers = CubeSize * CubeSize;
+
+/**
+ * @brief      A block of stickers copied from a source face into the destination face. The
+ * masked ring stickers are rotated clockwise by the given shift, the center is copied as is.
+ */
+struct tPackedTransfer
+{
+   uint8_t SrcFace;
+   uint8_t Shift;
+   PackedCube::PackedFace Mask;
+};
+
+/**
+ * @brief      Everything needed to execute one move on a packed cube. Every destination face is
+ * built from at most two source faces for every move in eCubeMove.
+ */
+struct tPackedMoveKernel
+{
+   static constexpr int MaxTransfers = 2;
+
+   std::array<std::array<tPackedTransfer, MaxTransfers>, NumFaces> Transfers;
+   std::array<uint8_t, NumFaces> NumTransfers;
+};
+
+using PackedMoveKernels =
+   std::array<tPackedMoveKernel, EnumToInt(eCubeMove::NumMoves)>;
+
+[[nodiscard]] static inline PackedCube::PackedFace RotateRing(PackedCube::PackedFace face, int shift)
+{
+   PackedCube::PackedFace ring = face & PackedCube::RingMask;
+   PackedCube::PackedFace center = face & ~PackedCube::RingMask;
+   ring = ((ring << shift) | (ring >> (PackedCube::CenterShift - shift))) & PackedCube::RingMask;
+   return ring | center;
+}
+
+/**
+ * @brief      Builds the kernel of a move by running it on a Cube where every sticker holds its
+ * own position instead of a color, then reading back where each sticker came from.
+ */
+static tPackedMoveKernel BuildKernel(eCubeMove move)
+{
+   constexpr int faceStride = static_cast<int>(std::tuple_size_v<SingleCubeFace>);
+   constexpr uint8_t unsetShift = 0xFF;
+
+   Cube labeledCube;
+   for (int face = 0; face < NumFaces; face++)
+   {
+      for (int idx = 0; idx < FaceStickers; idx++)
+      {
+         labeledCube.SetState(static_cast<eCubeFace>(face), idx % CubeSize, idx / CubeSize,
+            static_cast<eCubeColor>(face * faceStride + idx));
+      }
+   }
+
+   labeledCube.ExecuteMove(move);
+
+   tPackedMoveKernel kernel = {};
+   for (int face = 0; face < NumFaces; face++)
+   {
+      for (int idx = 0; idx < FaceStickers; idx++)
+      {
+         int label = EnumToInt(labeledCube.GetState(static_cast<eCubeFace>(face), idx % CubeSize,
+            idx / CubeSize));
+         int srcFace = label / faceStride;
+         int srcIdx = label % faceStride;
+
+         int srcShift = PackedCube::StickerShift(srcIdx);
+         int dstShift = PackedCube::StickerShift(idx);
+         bool isCenter = dstShift == PackedCube::CenterShift;
+
+         // Find the transfer from this source face, or start a new one.
+         int transferIdx = 0;
+         while (transferIdx < kernel.NumTransfers[face] &&
+                kernel.Transfers[face][transferIdx].SrcFace != srcFace)
+         {
+            transferIdx++;
+         }
+
+         tPackedTransfer& transfer = kernel.Transfers[face][transferIdx];
+         if (transferIdx == kernel.NumTransfers[face])
+         {
+            assert(transferIdx < tPackedMoveKernel::MaxTransfers && "Too many source faces.");
+            kernel.NumTransfers[face]++;
+            transfer.SrcFace = static_cast<uint8_t>(srcFace);
+            transfer.Shift = unsetShift;
+            transfer.Mask = 0;
+         }
+
+         // Centers always land on centers and don't need any rotation. A rigid turn keeps the
+         // clockwise order of a strip, so every ring sticker coming from the same face is rotated
+         // by the same amount.
+         if (!isCenter)
+         {
+            int shift = (dstShift - srcShift + PackedCube::CenterShift) % PackedCube::CenterShift;
+            assert((transfer.Shift == unsetShift || transfer.Shift == shift) &&
+                   "Inconsistent rotation between faces.");
+            transfer.Shift = static_cast<uint8_t>(shift);
+         }
+
+         transfer.Mask |= PackedCube::StickerMask << srcShift;
+      }
+
+      // Transfers that only carry a center.
+      for (int i = 0; i < kernel.NumTransfers[face]; i++)
+      {
+         if (kernel.Transfers[face][i].Shift == unsetShift)
+         {
+            kernel.Transfers[face][i].Shift = 0;
+         }
+      }
+   }
+
+   return kernel;
+}
+
+static const PackedMoveKernels& GetPackedMoveKernels()
+{
+   static const PackedMoveKernels kernels = []()
+   {
+      PackedMoveKernels result;
+      for (int i = 0; i < EnumToInt(eCubeMove::NumMoves); i++)
+      {
+         result[i] = BuildKernel(static_cast<eCubeMove>(i));
+      }
+
+      return result;
+   }();
+
+   return kernels;
+}
+
+PackedCube::PackedCube()
+{
+   SetSolved();
+}
+
+PackedCube::PackedCube(const Cube& cube)
+{
+   for (int face = 0; face < NumFaces; face++)
+   {
+      mFaces[face] = 0;
+      for (int idx = 0; idx < FaceStickers; idx++)
+      {
+         SetState(static_cast<eCubeFace>(face), idx % CubeSize, idx / CubeSize,
+            cube.GetState(static_cast<eCubeFace>(face), idx % CubeSize, idx / CubeSize));
+      }
+   }
+}
+
+void PackedCube::SetSolved()
+{
+   for (int face = 0; face < NumFaces; face++)
+   {
+      mFaces[face] = SolidFace(Cube::DefaultColorOfFace(static_cast<eCubeFace>(face)));
+   }
+}
+
+bool PackedCube::IsSolved() const
+{
+   for (int face = 0; face < NumFaces; face++)
+   {
+      if (mFaces[face] != SolidFace(ColorOfFace(static_cast<eCubeFace>(face))))
+      {
+         return false;
+      }
+   }
+
+   return true;
+}
+
+void PackedCube::Unpack(Cube& cube) const
+{
+   for (int face = 0; face < NumFaces; face++)
+   {
+      for (int idx = 0; idx < FaceStickers; idx++)
+      {
+         eCubeFace faceToken = static_cast<eCubeFace>(face);
+         cube.SetState(faceToken, idx % CubeSize, idx / CubeSize,
+            GetState(faceToken, idx % CubeSize, idx / CubeSize));
+      }
+   }
+}
+
+void PackedCube::ExecuteMove(eCubeMove move)
+{
+   assert(EnumToInt(move) < EnumToInt(eCubeMove::NumMoves) && "Invalid move");
+   const tPackedMoveKernel& kernel = GetPackedMoveKernels()[EnumToInt(move)];
+
+   std::array<PackedFace, NumFaces> result;
+   for (int face = 0; face < NumFaces; face++)
+   {
+      PackedFace packedFace = 0;
+      for (int i = 0; i < kernel.NumTransfers[face]; i++)
+      {
+         const tPackedTransfer& transfer = kernel.Transfers[face][i];
+         packedFace |= RotateRing(mFaces[transfer.SrcFace] & transfer.Mask, transfer.Shift);
+      }
+
+      result[face] = packedFace;
+   }
+
+   mFaces = result;
+}
+
+void PackedCube::ExecuteMoves(const eCubeMove* moves, size_t numMoves)
+{
+   for (size_t i = 0; i < numMoves; i++)
+   {
+      ExecuteMove(moves[i]);
+   }
+}
+}   // namespace cube
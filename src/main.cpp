@@ -20,7 +20,7 @@ int main()
 
    Cube cube;
    Timer t;
-   cube.ExecuteMoves(moves.data(), moves.size());
+   cube.ExecuteMovesParallel(moves.data(), moves.size());
    std::cout << "Executing moves took: " << t.Milliseconds() << " ms\n";
    cube.Print(std::cout);
 
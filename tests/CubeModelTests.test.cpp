@@ -0,0 +1,897 @@
+#include "CompiledAlgorithm.hpp"
+#include "CoordinateCube.hpp"
+#include "Cube.hpp"
+#include "CubeBatch.hpp"
+#include "CubePredicates.hpp"
+#include "CubieCube.hpp"
+#include "NxNCube.hpp"
+#include "PackedCube.hpp"
+
+#include <gtest/gtest.h>
+#include <random>
+#include <sstream>
+#include <tuple>
+#include <vector>
+
+using namespace cube;
+
+static void GenerateRandomMoves(std::vector<eCubeMove>& moves, int numMoves, int seed)
+{
+   std::mt19937 engine(seed);
+   std::uniform_int_distribution<int> randomMovesGen(0, EnumToInt(eCubeMove::NumMoves) - 1);
+
+   for (int i = 0; i < numMoves; i++)
+   {
+      moves.push_back(static_cast<eCubeMove>(randomMovesGen(engine)));
+   }
+}
+
+static void CompareCubes(const Cube& cube, const PackedCube& packedCube)
+{
+   for (int face = 0; face < EnumToInt(eCubeFace::NumFaces); face++)
+   {
+      for (int j = 0; j < CubeSize; j++)
+      {
+         for (int i = 0; i < CubeSize; i++)
+         {
+            eCubeFace faceToken = static_cast<eCubeFace>(face);
+            ASSERT_EQ(cube.GetState(faceToken, i, j), packedCube.GetState(faceToken, i, j));
+         }
+      }
+   }
+}
+
+TEST(PackedDefaultsTest, ModelTests)
+{
+   static_assert(sizeof(PackedCube) == 24, "Packed cube should be 24 bytes.");
+
+   PackedCube packedCube;
+   ASSERT_TRUE(packedCube.IsSolved());
+   CompareCubes(Cube(), packedCube);
+
+   packedCube.SetState(eCubeFace::Front, 2, 1, eCubeColor::Red);
+   ASSERT_EQ(packedCube.GetState(eCubeFace::Front, 2, 1), eCubeColor::Red);
+   ASSERT_EQ(packedCube.ColorOfFace(eCubeFace::Front), eCubeColor::Green);
+   ASSERT_FALSE(packedCube.IsSolved());
+}
+
+TEST(PackedEachMoveTest, ModelTests)
+{
+   // Start every move from the same scrambled state so every sticker is distinguishable enough.
+   std::vector<eCubeMove> scramble;
+   GenerateRandomMoves(scramble, 40, 7);
+
+   for (int i = 0; i < EnumToInt(eCubeMove::NumMoves); i++)
+   {
+      Cube cube;
+      cube.ExecuteMoves(scramble.data(), scramble.size());
+      PackedCube packedCube(cube);
+
+      eCubeMove move = static_cast<eCubeMove>(i);
+      cube.ExecuteMove(move);
+      packedCube.ExecuteMove(move);
+      CompareCubes(cube, packedCube);
+   }
+}
+
+TEST(PackedRandomMovesTest, ModelTests)
+{
+   std::vector<eCubeMove> moves;
+   GenerateRandomMoves(moves, 2000, 100);
+
+   Cube cube;
+   PackedCube packedCube;
+   cube.ExecuteMoves(moves.data(), moves.size());
+   packedCube.ExecuteMoves(moves.data(), moves.size());
+   CompareCubes(cube, packedCube);
+
+   Cube unpackedCube;
+   packedCube.Unpack(unpackedCube);
+   ASSERT_EQ(PackedCube(unpackedCube), packedCube);
+}
+
+static void CompareCubes(const Cube& cube, const Cube& otherCube)
+{
+   for (int face = 0; face < EnumToInt(eCubeFace::NumFaces); face++)
+   {
+      for (int j = 0; j < CubeSize; j++)
+      {
+         for (int i = 0; i < CubeSize; i++)
+         {
+            eCubeFace faceToken = static_cast<eCubeFace>(face);
+            ASSERT_EQ(cube.GetState(faceToken, i, j), otherCube.GetState(faceToken, i, j));
+         }
+      }
+   }
+}
+
+TEST(CubieConversionTest, ModelTests)
+{
+   CubieCube solved;
+   ASSERT_TRUE(solved.IsSolved());
+   ASSERT_EQ(CubieCube(Cube()), solved);
+
+   // Every move has to survive a round trip through the cubie model.
+   for (int i = 0; i < EnumToInt(eCubeMove::NumMoves); i++)
+   {
+      Cube cube;
+      cube.ExecuteMove(static_cast<eCubeMove>(i));
+
+      Cube convertedCube;
+      CubieCube(cube).Unpack(convertedCube);
+      CompareCubes(cube, convertedCube);
+   }
+
+   // A single R moves 4 corners and 4 edges.
+   CubieCube cubieCube;
+   cubieCube.ExecuteMove(eCubeMove::Right);
+   ASSERT_EQ(cubieCube.GetCorner(eCorner::URF), eCorner::DFR);
+   ASSERT_EQ(cubieCube.GetCornerTwist(eCorner::URF), 2);
+   ASSERT_EQ(cubieCube.GetEdge(eEdge::UR), eEdge::FR);
+   ASSERT_EQ(cubieCube.GetEdgeFlip(eEdge::UR), 0);
+   ASSERT_EQ(cubieCube.GetCorner(eCorner::UFL), eCorner::UFL);
+}
+
+TEST(CubieRandomMovesTest, ModelTests)
+{
+   for (int trial = 0; trial < 10; trial++)
+   {
+      std::vector<eCubeMove> moves;
+      GenerateRandomMoves(moves, 500, trial * 100);
+
+      Cube cube;
+      CubieCube cubieCube;
+      cube.ExecuteMoves(moves.data(), moves.size());
+      cubieCube.ExecuteMoves(moves.data(), moves.size());
+
+      ASSERT_EQ(CubieCube(cube), cubieCube);
+
+      Cube convertedCube;
+      cubieCube.Unpack(convertedCube);
+      CompareCubes(cube, convertedCube);
+   }
+}
+
+TEST(CubieInverseTest, ModelTests)
+{
+   for (int trial = 0; trial < 10; trial++)
+   {
+      std::vector<eCubeMove> moves;
+      std::vector<eCubeMove> reverseMoves;
+      GenerateRandomMoves(moves, 100, trial);
+      Cube::ReverseMoves(moves, reverseMoves);
+
+      CubieCube cubieCube;
+      cubieCube.ExecuteMoves(moves.data(), moves.size());
+
+      // The inverse is the state the reversed moves lead to.
+      CubieCube inverse = cubieCube.Inverse();
+      CubieCube replayed;
+      replayed.ExecuteMoves(reverseMoves.data(), reverseMoves.size());
+      ASSERT_EQ(inverse, replayed);
+      ASSERT_EQ(inverse.Inverse(), cubieCube);
+
+      CubieCube product = cubieCube;
+      product.Multiply(inverse);
+      ASSERT_TRUE(product.IsSolved());
+      inverse.Multiply(cubieCube);
+      ASSERT_TRUE(inverse.IsSolved());
+   }
+
+   // Compiled algorithms invert the same way.
+   std::vector<eCubeMove> moves;
+   GenerateRandomMoves(moves, 30, 5);
+   CompiledAlgorithm algorithm(moves);
+   CompiledAlgorithm inverse = algorithm.Inverse();
+
+   std::vector<eCubeMove> reverseMoves;
+   Cube::ReverseMoves(moves, reverseMoves);
+   ASSERT_EQ(inverse, CompiledAlgorithm(reverseMoves));
+   ASSERT_EQ(inverse.GetMoves(), reverseMoves);
+
+   Cube cube;
+   cube.ExecuteAlgorithm(algorithm);
+   cube.ExecuteAlgorithm(inverse);
+   ASSERT_TRUE(cube.IsSolved());
+}
+
+TEST(CubieInvalidFaceletsTest, ModelTests)
+{
+   Cube cube;
+   CubieCube cubieCube;
+
+   // Two green stickers on the same edge.
+   cube.SetState(eCubeFace::Top, 1, 2, eCubeColor::Green);
+   ASSERT_FALSE(CubieCube::FromFaceData(cube.GetFaceData(), cubieCube));
+
+   // A corner that is a mirror image of a real one.
+   cube.SetSolved();
+   cube.SetState(eCubeFace::Right, 0, 0, eCubeColor::Green);
+   cube.SetState(eCubeFace::Front, 2, 0, eCubeColor::Orange);
+   ASSERT_FALSE(CubieCube::FromFaceData(cube.GetFaceData(), cubieCube));
+
+   // A failed conversion leaves the result as it was.
+   CubieCube moved;
+   moved.Multiply(CubieCube::GetMoveCube(eCubeMove::Right));
+   CubieCube unchanged = moved;
+   ASSERT_FALSE(CubieCube::FromFaceData(cube.GetFaceData(), moved));
+   ASSERT_TRUE(moved == unchanged);
+}
+
+static void SwapStickers(
+   Cube& cube, eCubeFace face1, int x1, int y1, eCubeFace face2, int x2, int y2)
+{
+   eCubeColor color = cube.GetState(face1, x1, y1);
+   cube.SetState(face1, x1, y1, cube.GetState(face2, x2, y2));
+   cube.SetState(face2, x2, y2, color);
+}
+
+TEST(CubeValidityTest, ModelTests)
+{
+   // Every reachable state is valid, including ones with slice moves and rotations.
+   std::vector<Cube> cubes;
+   for (int trial = 0; trial < 20; trial++)
+   {
+      std::vector<eCubeMove> moves;
+      GenerateRandomMoves(moves, 100, trial);
+
+      Cube cube;
+      cube.SetVirtualRotations(trial % 2 == 0);
+      cube.ExecuteMoves(moves.data(), moves.size());
+      ASSERT_EQ(cube.CheckValidity(), eCubeValidity::Valid);
+      ASSERT_TRUE(cube.Validate());
+      cube.Flatten();
+      cubes.push_back(cube);
+   }
+
+   // Every kind of broken cube, built from a scrambled one.
+   for (int i = 0; i < 6; i++)
+   {
+      Cube cube = cubes[i];
+      switch (i)
+      {
+      case 0:
+      {
+         int color = EnumToInt(cube.GetState(eCubeFace::Top, 0, 0));
+         cube.SetState(eCubeFace::Top, 0, 0,
+            static_cast<eCubeColor>((color + 1) % EnumToInt(eCubeColor::NumColors)));
+         break;
+      }
+      case 1:
+         SwapStickers(cube, eCubeFace::Top, 1, 1, eCubeFace::Bottom, 1, 1);
+         break;
+      case 2:
+         // The top front right corner twisted in place.
+         SwapStickers(cube, eCubeFace::Top, 2, 2, eCubeFace::Right, 0, 0);
+         SwapStickers(cube, eCubeFace::Right, 0, 0, eCubeFace::Front, 2, 0);
+         break;
+      case 3:
+         // The top front edge flipped in place.
+         SwapStickers(cube, eCubeFace::Top, 1, 2, eCubeFace::Front, 1, 0);
+         break;
+      case 4:
+         // The top front and top right edges swapped.
+         SwapStickers(cube, eCubeFace::Top, 1, 2, eCubeFace::Top, 2, 1);
+         SwapStickers(cube, eCubeFace::Front, 1, 0, eCubeFace::Right, 1, 0);
+         break;
+      default:
+         // A corner sticker swapped with an edge sticker of another color.
+         SwapStickers(cube, eCubeFace::Top, 0, 0, eCubeFace::Top, 1, 0);
+         if (cube.GetState(eCubeFace::Top, 0, 0) == cube.GetState(eCubeFace::Top, 1, 0))
+         {
+            SwapStickers(cube, eCubeFace::Top, 0, 0, eCubeFace::Front, 1, 0);
+         }
+         break;
+      }
+
+      constexpr std::array<eCubeValidity, 6> expected = { eCubeValidity::InvalidColors,
+         eCubeValidity::InvalidCenters, eCubeValidity::TwistedCorner, eCubeValidity::FlippedEdge,
+         eCubeValidity::ParityError, eCubeValidity::InvalidPiece };
+      ASSERT_EQ(cube.CheckValidity(), expected[i]);
+      ASSERT_FALSE(cube.Validate());
+      cubes.push_back(cube);
+   }
+
+   // The batch gives the same answers.
+   CubeBatch batch(cubes.size());
+   for (size_t i = 0; i < cubes.size(); i++)
+   {
+      batch.SetCube(i, cubes[i]);
+   }
+
+   std::vector<eCubeValidity> results;
+   batch.CheckValidity(results);
+   for (size_t i = 0; i < cubes.size(); i++)
+   {
+      ASSERT_EQ(results[i], cubes[i].CheckValidity());
+   }
+}
+
+TEST(ShuffleEngineTest, ModelTests)
+{
+   static_assert(sizeof(SingleCubeFace) == 16, "A face should fit in a single SSE register.");
+
+   if (!Cube::IsMoveEngineSupported(eMoveEngine::Shuffle))
+   {
+      GTEST_SKIP() << "Shuffle engine not supported on this CPU.";
+   }
+
+   std::vector<eCubeMove> moves;
+   GenerateRandomMoves(moves, 2000, 3);
+
+   eMoveEngine defaultEngine = Cube::GetMoveEngine();
+   Cube scalarCube;
+   Cube shuffleCube;
+
+   for (eCubeMove move : moves)
+   {
+      Cube::SetMoveEngine(eMoveEngine::Scalar);
+      scalarCube.ExecuteMove(move);
+      Cube::SetMoveEngine(eMoveEngine::Shuffle);
+      shuffleCube.ExecuteMove(move);
+
+      // Padding included, both engines have to keep it zero.
+      ASSERT_EQ(scalarCube.GetFaceData(), shuffleCube.GetFaceData());
+   }
+
+   Cube::SetMoveEngine(defaultEngine);
+}
+
+TEST(BlockMovesTest, ModelTests)
+{
+   // Long enough for several blocks and a partial last one.
+   std::vector<eCubeMove> moves;
+   GenerateRandomMoves(moves, 1000, 8);
+
+   eMoveEngine defaultEngine = Cube::GetMoveEngine();
+   for (eMoveEngine engine : { eMoveEngine::Scalar, eMoveEngine::Shuffle })
+   {
+      if (!Cube::IsMoveEngineSupported(engine))
+      {
+         continue;
+      }
+
+      Cube::SetMoveEngine(engine);
+      for (bool virtualRotations : { false, true })
+      {
+         Cube cube;
+         Cube blockCube;
+         for (Cube* target : { &cube, &blockCube })
+         {
+            target->SetVirtualRotations(virtualRotations);
+            target->SetPieceTracking(true);
+         }
+
+         for (eCubeMove move : moves)
+         {
+            cube.ExecuteMove(move);
+         }
+
+         blockCube.ExecuteMoves(std::span<const eCubeMove>(moves));
+         ASSERT_TRUE(cube == blockCube);
+         ASSERT_EQ(cube.GetOrientation(), blockCube.GetOrientation());
+         ASSERT_EQ(cube.GetStoredFaceData(), blockCube.GetStoredFaceData());
+
+         // Flattening stores the stickers the way they are seen and moves the piece index along.
+         Cube flattened = cube;
+         flattened.Flatten();
+         CubeFaceData seen;
+         cube.CopyFaceData(seen);
+         ASSERT_EQ(flattened.GetOrientation(), 0);
+         ASSERT_EQ(flattened.GetStoredFaceData(), seen);
+
+         eCubeFace face, flattenedFace;
+         int x, y, flattenedX, flattenedY;
+         ASSERT_TRUE(cube.LocatePiece(eCubeColor::Red, eCubeColor::Yellow, eCubeColor::Green,
+            face, x, y));
+         ASSERT_TRUE(flattened.LocatePiece(eCubeColor::Red, eCubeColor::Yellow, eCubeColor::Green,
+            flattenedFace, flattenedX, flattenedY));
+         ASSERT_EQ(std::tuple(face, x, y), std::tuple(flattenedFace, flattenedX, flattenedY));
+
+         // Undoing the moves in one call brings back the solved cube and its piece index.
+         std::vector<eCubeMove> reverse;
+         Cube::ReverseMoves(moves, reverse);
+         blockCube.ExecuteMoves(reverse.data(), reverse.size());
+         ASSERT_TRUE(blockCube.IsSolved());
+         ASSERT_TRUE(blockCube.IsPieceAt(eCubeColor::Yellow, eCubeColor::Green,
+            eCubeFace::Front, 1, 0));
+      }
+   }
+
+   Cube::SetMoveEngine(defaultEngine);
+}
+
+TEST(CompiledAlgorithmTest, ModelTests)
+{
+   eMoveEngine defaultEngine = Cube::GetMoveEngine();
+
+   for (eMoveEngine engine : { eMoveEngine::Scalar, eMoveEngine::Shuffle })
+   {
+      if (!Cube::IsMoveEngineSupported(engine))
+      {
+         continue;
+      }
+
+      Cube::SetMoveEngine(engine);
+      for (int trial = 0; trial < 10; trial++)
+      {
+         std::vector<eCubeMove> moves;
+         GenerateRandomMoves(moves, 30, trial);
+         CompiledAlgorithm algorithm(moves);
+         ASSERT_EQ(algorithm.GetMoves(), moves);
+
+         // Start from a scrambled state so the permutation is applied to something other than solved.
+         std::vector<eCubeMove> scramble;
+         GenerateRandomMoves(scramble, 40, trial + 1000);
+         Cube cube;
+         cube.ExecuteMoves(scramble.data(), scramble.size());
+         Cube compiledCube = cube;
+
+         cube.ExecuteMoves(moves.data(), moves.size());
+         compiledCube.ExecuteAlgorithm(algorithm);
+         ASSERT_EQ(cube.GetFaceData(), compiledCube.GetFaceData());
+      }
+   }
+
+   Cube::SetMoveEngine(defaultEngine);
+
+   // Appending is the same as compiling the concatenated moves.
+   std::vector<eCubeMove> first;
+   std::vector<eCubeMove> second;
+   GenerateRandomMoves(first, 20, 1);
+   GenerateRandomMoves(second, 20, 2);
+
+   CompiledAlgorithm appended(first);
+   appended.Append(CompiledAlgorithm(second));
+
+   std::vector<eCubeMove> combined = first;
+   combined.insert(combined.end(), second.begin(), second.end());
+   ASSERT_EQ(appended, CompiledAlgorithm(combined));
+   ASSERT_EQ(appended.GetMoves(), combined);
+
+   // An empty algorithm is the identity.
+   Cube cube;
+   cube.ExecuteAlgorithm(CompiledAlgorithm());
+   ASSERT_TRUE(cube.IsSolved());
+}
+
+TEST(ParallelMovesTest, ModelTests)
+{
+   std::vector<eCubeMove> moves;
+   GenerateRandomMoves(moves, 1 << 18, 5);
+
+   Cube cube;
+   cube.ExecuteMoves(moves.data(), moves.size());
+
+   // Uneven thread counts leave a longer last chunk and an unbalanced reduction tree.
+   for (unsigned numThreads : { 1u, 2u, 3u, 0u })
+   {
+      Cube parallelCube;
+      parallelCube.ExecuteMovesParallel(moves.data(), moves.size(), numThreads);
+      ASSERT_EQ(cube.GetFaceData(), parallelCube.GetFaceData());
+   }
+}
+
+TEST(CubeBatchTest, ModelTests)
+{
+   constexpr int numCubes = 100;
+   CubeBatch batch(numCubes);
+
+   std::vector<uint8_t> results;
+   batch.IsSolved(results);
+   ASSERT_EQ(results, std::vector<uint8_t>(numCubes, 1));
+
+   // Every cube gets its own scramble, leave the last one solved.
+   std::vector<Cube> cubes(numCubes);
+   for (int i = 0; i < numCubes - 1; i++)
+   {
+      std::vector<eCubeMove> scramble;
+      GenerateRandomMoves(scramble, 20, i);
+      cubes[i].ExecuteMoves(scramble.data(), scramble.size());
+      batch.SetCube(i, cubes[i]);
+   }
+
+   std::vector<eCubeMove> moves;
+   GenerateRandomMoves(moves, 200, 12345);
+   batch.ExecuteMoves(moves.data(), moves.size());
+
+   std::vector<uint8_t> topSolved;
+   batch.IsSolved(results);
+   batch.IsFaceSolved(eCubeFace::Top, topSolved);
+
+   for (int i = 0; i < numCubes; i++)
+   {
+      cubes[i].ExecuteMoves(moves.data(), moves.size());
+
+      Cube batchCube;
+      batch.GetCube(i, batchCube);
+      CompareCubes(cubes[i], batchCube);
+      ASSERT_EQ(results[i], cubes[i].IsSolved());
+   }
+
+   // Undo the moves, only the last cube comes back solved.
+   std::vector<eCubeMove> reverseMoves;
+   Cube::ReverseMoves(moves, reverseMoves);
+   batch.ExecuteMoves(reverseMoves.data(), reverseMoves.size());
+   batch.IsSolved(results);
+   batch.IsFaceColor(eCubeFace::Top, eCubeColor::Yellow, topSolved);
+   for (int i = 0; i < numCubes - 1; i++)
+   {
+      ASSERT_EQ(results[i], 0);
+   }
+
+   ASSERT_EQ(results[numCubes - 1], 1);
+   ASSERT_EQ(topSolved[numCubes - 1], 1);
+}
+
+TEST(StickerPredicateTest, ModelTests)
+{
+   Cube cube;
+   ASSERT_TRUE(StickerPredicate::Solved().Matches(cube));
+   ASSERT_TRUE(StickerPredicate::OrientedLastLayer().Matches(cube));
+
+   // Top layer moves keep the first two layers, R U R' breaks the front right pair only.
+   cube.ExecuteMove(eCubeMove::Up);
+   ASSERT_FALSE(StickerPredicate::Solved().Matches(cube));
+   ASSERT_TRUE(StickerPredicate::FaceSolved(eCubeFace::Top).Matches(cube));
+   ASSERT_TRUE(StickerPredicate::FirstTwoLayers().Matches(cube));
+
+   std::vector<eCubeMove> moves = { eCubeMove::Right, eCubeMove::Up, eCubeMove::RightPrime };
+   cube.ExecuteMoves(moves.data(), moves.size());
+   ASSERT_TRUE(StickerPredicate::Cross().Matches(cube));
+   ASSERT_FALSE(StickerPredicate::FirstTwoLayers().Matches(cube));
+   ASSERT_FALSE(StickerPredicate::F2lPair(eCubeFace::Front, eCubeFace::Right).Matches(cube));
+   ASSERT_FALSE(StickerPredicate::F2lPair(eCubeFace::Right, eCubeFace::Front).Matches(cube));
+   ASSERT_TRUE(StickerPredicate::F2lPair(eCubeFace::Front, eCubeFace::Left).Matches(cube));
+   ASSERT_TRUE(StickerPredicate::F2lPair(eCubeFace::Back, eCubeFace::Left).Matches(cube));
+   ASSERT_TRUE(StickerPredicate::F2lPair(eCubeFace::Back, eCubeFace::Right).Matches(cube));
+
+   // F breaks exactly the front cross edge.
+   cube.SetSolved();
+   cube.ExecuteMove(eCubeMove::Front);
+   ASSERT_FALSE(StickerPredicate::CrossEdge(eCubeFace::Front).Matches(cube));
+   ASSERT_TRUE(StickerPredicate::CrossEdge(eCubeFace::Back).Matches(cube));
+   ASSERT_FALSE(StickerPredicate::Cross().Matches(cube));
+
+   // Fixed colors don't follow the centers.
+   StickerPredicate yellowTop;
+   yellowTop.RequireColor(eCubeFace::Top, 1, 1, eCubeColor::Yellow);
+   cube.SetSolved();
+   ASSERT_TRUE(yellowTop.Matches(cube));
+   cube.ExecuteMove(eCubeMove::X);
+   ASSERT_FALSE(yellowTop.Matches(cube));
+   ASSERT_TRUE(StickerPredicate::Solved().Matches(cube));
+
+   // Cubes seen through an orientation, every engine and batches all agree with a flat cube.
+   eMoveEngine defaultEngine = Cube::GetMoveEngine();
+   std::vector<const StickerPredicate*> predicates = { &StickerPredicate::Solved(),
+      &StickerPredicate::Cross(), &StickerPredicate::FirstTwoLayers(),
+      &StickerPredicate::OrientedLastLayer(), &StickerPredicate::CrossEdge(eCubeFace::Left),
+      &StickerPredicate::FaceSolved(eCubeFace::Front), &yellowTop };
+
+   constexpr int numCubes = 50;
+   CubeBatch batch(numCubes);
+   std::vector<Cube> flatCubes(numCubes);
+   std::vector<Cube> virtualCubes(numCubes);
+   for (int i = 0; i < numCubes; i++)
+   {
+      // Short sequences of rotations and last layer moves so some predicates still hold.
+      std::vector<eCubeMove> sequence;
+      std::mt19937 engine(i);
+      std::uniform_int_distribution<int> randomMovesGen(0, 5);
+      constexpr std::array<eCubeMove, 6> choices = { eCubeMove::Up, eCubeMove::UpPrime,
+         eCubeMove::Y, eCubeMove::X2, eCubeMove::Right, eCubeMove::Z };
+      for (int j = 0; j < i % 6; j++)
+      {
+         sequence.push_back(choices[randomMovesGen(engine)]);
+      }
+
+      virtualCubes[i].SetVirtualRotations(true);
+      flatCubes[i].ExecuteMoves(sequence.data(), sequence.size());
+      virtualCubes[i].ExecuteMoves(sequence.data(), sequence.size());
+      batch.SetCube(i, flatCubes[i]);
+   }
+
+   for (const StickerPredicate* predicate : predicates)
+   {
+      std::vector<uint8_t> results;
+      predicate->Matches(batch, results);
+
+      for (eMoveEngine engine : { eMoveEngine::Scalar, eMoveEngine::Shuffle })
+      {
+         if (!Cube::IsMoveEngineSupported(engine))
+         {
+            continue;
+         }
+
+         Cube::SetMoveEngine(engine);
+         for (int i = 0; i < numCubes; i++)
+         {
+            bool expected = predicate->Matches(flatCubes[i]);
+            ASSERT_EQ(predicate->Matches(virtualCubes[i]), expected);
+            ASSERT_EQ(results[i], expected);
+         }
+      }
+   }
+
+   Cube::SetMoveEngine(defaultEngine);
+}
+
+/**
+ * @brief      Checks what holds for every size: undoing any layer turn, undoing a scramble and the
+ * order of R U R' U'.
+ */
+template <int N>
+static void CheckLayerMoves(int seed)
+{
+   for (int axis = 0; axis < 3; axis++)
+   {
+      for (int layer = 0; layer < N; layer++)
+      {
+         for (int quarterTurns = 1; quarterTurns < 4; quarterTurns++)
+         {
+            NxNCube<N> cube;
+            uint8_t layerIdx = static_cast<uint8_t>(layer);
+            cube.ExecuteMove({ static_cast<eCubeAxis>(axis), layerIdx, layerIdx,
+               static_cast<uint8_t>(quarterTurns) });
+            ASSERT_FALSE(cube.IsSolved());
+            cube.ExecuteMove({ static_cast<eCubeAxis>(axis), layerIdx, layerIdx,
+               static_cast<uint8_t>(4 - quarterTurns) });
+            ASSERT_TRUE(cube.IsSolved());
+         }
+      }
+   }
+
+   std::mt19937 engine(seed);
+   std::uniform_int_distribution<int> axisGen(0, 2);
+   std::uniform_int_distribution<int> layerGen(0, N - 1);
+   std::uniform_int_distribution<int> turnsGen(1, 3);
+
+   NxNCube<N> cube;
+   std::vector<tLayerMove> scramble;
+   for (int i = 0; i < 100; i++)
+   {
+      int first = layerGen(engine);
+      int last = layerGen(engine);
+      scramble.push_back({ static_cast<eCubeAxis>(axisGen(engine)),
+         static_cast<uint8_t>(std::min(first, last)), static_cast<uint8_t>(std::max(first, last)),
+         static_cast<uint8_t>(turnsGen(engine)) });
+   }
+
+   cube.ExecuteMoves(scramble);
+   ASSERT_FALSE(cube.IsSolved());
+   for (auto move = scramble.rbegin(); move != scramble.rend(); move++)
+   {
+      tLayerMove inverse = *move;
+      inverse.QuarterTurns = static_cast<uint8_t>(4 - move->QuarterTurns);
+      cube.ExecuteMove(inverse);
+   }
+
+   ASSERT_TRUE(cube.IsSolved());
+
+   std::vector<tLayerMove> moves;
+   NxNCube<N>::ParseMoveNotation("R U R' U'", moves);
+   ASSERT_EQ(moves.size(), 4u);
+   for (int i = 0; i < 6; i++)
+   {
+      cube.ExecuteMoves(moves);
+      ASSERT_EQ(cube.IsSolved(), i == 5);
+   }
+
+   // Whole cube rotations never unsolve it.
+   moves.clear();
+   NxNCube<N>::ParseMoveNotation("x y' z2", moves);
+   cube.ExecuteMoves(moves);
+   ASSERT_TRUE(cube.IsSolved());
+}
+
+/**
+ * @brief      Returns true if both sequences leave the cube in the same state.
+ */
+template <int N>
+static bool IsSameTransform(const std::string& notation, const std::string& otherNotation)
+{
+   std::mt19937 engine(1);
+   std::uniform_int_distribution<int> axisGen(0, 2);
+   std::uniform_int_distribution<int> layerGen(0, N - 1);
+
+   // Start from a scramble, a solved cube hides what rotations do.
+   NxNCube<N> cube;
+   for (int i = 0; i < 50; i++)
+   {
+      uint8_t layer = static_cast<uint8_t>(layerGen(engine));
+      cube.ExecuteMove({ static_cast<eCubeAxis>(axisGen(engine)), layer, layer, 1 });
+   }
+
+   NxNCube<N> otherCube = cube;
+   std::vector<tLayerMove> moves;
+   std::vector<tLayerMove> otherMoves;
+   NxNCube<N>::ParseMoveNotation(notation, moves);
+   NxNCube<N>::ParseMoveNotation(otherNotation, otherMoves);
+   cube.ExecuteMoves(moves);
+   otherCube.ExecuteMoves(otherMoves);
+   return cube == otherCube;
+}
+
+TEST(CoordinateCubeTest, ModelTests)
+{
+   CoordinateCube::PrepareMoveTables();
+
+   CoordinateCube solved;
+   ASSERT_TRUE(solved.AreCoordinatesSolved());
+   ASSERT_EQ(CoordinateCube(Cube()), solved);
+
+   // Every value survives a round trip through the cubie model.
+   for (int twist = 0; twist < NumCornerTwists; twist++)
+   {
+      CubieCube cubieCube;
+      CoordinateCube::SetCornerTwist(cubieCube, twist);
+      ASSERT_EQ(CoordinateCube::GetCornerTwist(cubieCube), twist);
+   }
+
+   for (int flip = 0; flip < NumEdgeFlips; flip++)
+   {
+      CubieCube cubieCube;
+      CoordinateCube::SetEdgeFlip(cubieCube, flip);
+      ASSERT_EQ(CoordinateCube::GetEdgeFlip(cubieCube), flip);
+   }
+
+   for (int slice = 0; slice < NumUDSlices; slice++)
+   {
+      CubieCube cubieCube;
+      CoordinateCube::SetUDSlice(cubieCube, slice);
+      ASSERT_EQ(CoordinateCube::GetUDSlice(cubieCube), slice);
+   }
+
+   for (int permutation = 0; permutation < NumCornerPermutations; permutation++)
+   {
+      CubieCube cubieCube;
+      CoordinateCube::SetCornerPermutation(cubieCube, permutation);
+      ASSERT_EQ(CoordinateCube::GetCornerPermutation(cubieCube), permutation);
+   }
+
+   for (uint32_t permutation : { 0u, 1u, 123456789u, NumEdgePermutations - 1 })
+   {
+      CubieCube cubieCube;
+      CoordinateCube::SetEdgePermutation(cubieCube, permutation);
+      ASSERT_EQ(CoordinateCube::GetEdgePermutation(cubieCube), permutation);
+   }
+
+   // Table lookups agree with converting the moved cube, for every kind of move.
+   std::vector<eCubeMove> moves;
+   GenerateRandomMoves(moves, 1000, 17);
+
+   Cube cube;
+   CoordinateCube coordinateCube;
+   for (eCubeMove move : moves)
+   {
+      cube.ExecuteMove(move);
+      coordinateCube.ExecuteMove(move);
+      ASSERT_EQ(coordinateCube, CoordinateCube(cube));
+   }
+
+   // R U R' U' has order 6.
+   std::vector<eCubeMove> sexyMove = { eCubeMove::Right, eCubeMove::Up, eCubeMove::RightPrime,
+      eCubeMove::UpPrime };
+   CoordinateCube cycled;
+   for (int i = 0; i < 6; i++)
+   {
+      ASSERT_EQ(cycled.AreCoordinatesSolved(), i == 0);
+      cycled.ExecuteMoves(sexyMove.data(), sexyMove.size());
+   }
+
+   ASSERT_TRUE(cycled.AreCoordinatesSolved());
+
+   // Edges alone aren't tracked: a U perm leaves the coordinates solved.
+   std::vector<eCubeMove> uPerm;
+   Cube::ParseMoveNotation("R U' R U R U R U' R' U' R2", uPerm);
+   Cube uPermCube;
+   uPermCube.ExecuteMoves(uPerm.data(), uPerm.size());
+   ASSERT_FALSE(uPermCube.IsSolved());
+   ASSERT_TRUE(CoordinateCube(uPermCube).AreCoordinatesSolved());
+}
+
+TEST(NxNCube2Test, ModelTests)
+{
+   CheckLayerMoves<2>(2);
+
+   // On 2x2 the second layer from a face is the opposite face.
+   ASSERT_TRUE(IsSameTransform<2>("2R", "L'"));
+   ASSERT_TRUE(IsSameTransform<2>("Uw", "y"));
+   ASSERT_FALSE(IsSameTransform<2>("R", "L'"));
+
+   std::vector<tLayerMove> moves;
+   tNotationResult result = NxNCube<2>::ParseMoveNotation("3R M Rw3 2R2'", moves);
+   ASSERT_EQ(moves.size(), 1u);
+   ASSERT_EQ(result.NumMoves, 1u);
+   ASSERT_EQ(result.Error, eNotationError::InvalidMove);
+   ASSERT_EQ(result.ErrorOffset, 0u);
+   ASSERT_EQ(result.ErrorLength, 2u);
+   ASSERT_EQ(result.NumSkippedMoves, 3u);
+}
+
+TEST(NxNCube3Test, ModelTests)
+{
+   CheckLayerMoves<3>(3);
+
+   // Same stickers as Cube for every 3x3 move.
+   std::vector<eCubeMove> scramble;
+   GenerateRandomMoves(scramble, 500, 3);
+   std::ostringstream notation;
+   Cube::SerializeMoveList(notation, scramble.data(), scramble.size(), false);
+
+   std::vector<tLayerMove> moves;
+   tNotationResult result = NxNCube<3>::ParseMoveNotation(notation.str(), moves);
+   ASSERT_EQ(result.Error, eNotationError::None);
+   ASSERT_EQ(moves.size(), scramble.size());
+
+   Cube cube;
+   NxNCube<3> nxnCube;
+   for (size_t i = 0; i < scramble.size(); i++)
+   {
+      cube.ExecuteMove(scramble[i]);
+      nxnCube.ExecuteMove(moves[i]);
+
+      for (int face = 0; face < EnumToInt(eCubeFace::NumFaces); face++)
+      {
+         eCubeFace faceToken = static_cast<eCubeFace>(face);
+         for (int idx = 0; idx < CubeSize * CubeSize; idx++)
+         {
+            ASSERT_EQ(cube.GetState(faceToken, idx % CubeSize, idx / CubeSize),
+               nxnCube.GetState(faceToken, idx % CubeSize, idx / CubeSize));
+         }
+      }
+   }
+
+   ASSERT_TRUE(IsSameTransform<3>("2R", "M'"));
+   ASSERT_TRUE(IsSameTransform<3>("3Rw", "x"));
+}
+
+TEST(NxNCube4Test, ModelTests)
+{
+   CheckLayerMoves<4>(4);
+
+   ASSERT_TRUE(IsSameTransform<4>("Rw", "R 2R"));
+   ASSERT_TRUE(IsSameTransform<4>("r'", "2R' R'"));
+   ASSERT_TRUE(IsSameTransform<4>("3Uw2", "U2 2U2 3U2"));
+   ASSERT_TRUE(IsSameTransform<4>("x", "R 2R 3R L'"));
+   ASSERT_TRUE(IsSameTransform<4>("2F", "3B'"));
+   ASSERT_FALSE(IsSameTransform<4>("2R", "3R"));
+
+   // No single middle layer on even cubes, and no fifth layer.
+   std::vector<tLayerMove> moves;
+   tNotationResult result = NxNCube<4>::ParseMoveNotation("M E S 5R 0R 2x", moves);
+   ASSERT_TRUE(moves.empty());
+   ASSERT_EQ(result.NumMoves, 0u);
+   ASSERT_EQ(result.Error, eNotationError::InvalidMove);
+   ASSERT_EQ(result.ErrorOffset, 0u);
+   ASSERT_EQ(result.ErrorLength, 1u);
+   ASSERT_EQ(result.NumSkippedMoves, 6u);
+}
+
+TEST(NxNCube5Test, ModelTests)
+{
+   CheckLayerMoves<5>(5);
+
+   ASSERT_TRUE(IsSameTransform<5>("M", "3L"));
+   ASSERT_TRUE(IsSameTransform<5>("E'", "3D'"));
+   ASSERT_TRUE(IsSameTransform<5>("S2", "3F2"));
+   ASSERT_TRUE(IsSameTransform<5>("3Uw", "U 2U 3U"));
+   ASSERT_TRUE(IsSameTransform<5>("5Lw", "x'"));
+   ASSERT_FALSE(IsSameTransform<5>("2R", "2L'"));
+
+   std::vector<tLayerMove> moves;
+   tNotationResult result = NxNCube<5>::ParseMoveNotation("5R 6R", moves);
+   ASSERT_EQ(moves.size(), 1u);
+   ASSERT_EQ(result.Error, eNotationError::InvalidMove);
+   ASSERT_EQ(result.ErrorOffset, 3u);
+   ASSERT_EQ(result.ErrorLength, 2u);
+   ASSERT_EQ(result.NumSkippedMoves, 1u);
+   ASSERT_EQ(moves[0], (tLayerMove{ eCubeAxis::XAxis, 0, 0, 3 }));
+}
+
+int main(int argc, char** argv)
+{
+   testing::InitGoogleTest(&argc, argv);
+   return RUN_ALL_TESTS();
+}
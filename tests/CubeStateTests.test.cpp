@@ -1,8 +1,16 @@
+#include "CompiledAlgorithm.hpp"
 #include "Cube.hpp"
+#include "CubeGeometry.hpp"
+#include "CubeMoves.hpp"
+#include "CubeSolver.hpp"
+#include "MoveBuffer.hpp"
+#include "MoveNotation.hpp"
 
 #include <array>
 #include <gtest/gtest.h>
 #include <random>
+#include <sstream>
+#include <unordered_set>
 
 using namespace cube;
 
@@ -216,8 +224,634 @@ TEST(RandomMovesTest, StateTests)
    }
 }
 
+TEST(VirtualRotationsTest, StateTests)
+{
+   Cube cube;
+   Cube virtualCube;
+   virtualCube.SetVirtualRotations(true);
+
+   std::mt19937 engine(42);
+   std::uniform_int_distribution<int> randomMovesGen(0, EnumToInt(eCubeMove::NumMoves) - 1);
+
+   for (int i = 0; i < 2000; i++)
+   {
+      eCubeMove move = static_cast<eCubeMove>(randomMovesGen(engine));
+      cube.ExecuteMove(move);
+      virtualCube.ExecuteMove(move);
+
+      for (int face = 0; face < EnumToInt(eCubeFace::NumFaces); face++)
+      {
+         eCubeFace faceToken = static_cast<eCubeFace>(face);
+         ASSERT_EQ(cube.ColorOfFace(faceToken), virtualCube.ColorOfFace(faceToken));
+         for (int j = 0; j < CubeSize; j++)
+         {
+            for (int k = 0; k < CubeSize; k++)
+            {
+               ASSERT_EQ(cube.GetState(faceToken, j, k), virtualCube.GetState(faceToken, j, k));
+            }
+         }
+      }
+   }
+
+   // Rotations alone never touch the stickers.
+   Cube rotatedCube;
+   rotatedCube.SetVirtualRotations(true);
+   rotatedCube.ExecuteMove(eCubeMove::X);
+   rotatedCube.ExecuteMove(eCubeMove::YPrime);
+   ASSERT_NE(rotatedCube.GetOrientation(), 0);
+   ASSERT_EQ(rotatedCube.ColorOfFace(eCubeFace::Front), eCubeColor::Red);
+   rotatedCube.ExecuteMove(eCubeMove::Y);
+   rotatedCube.ExecuteMove(eCubeMove::XPrime);
+   ASSERT_EQ(rotatedCube.GetOrientation(), 0);
+
+   // Flattening keeps what is seen and stores it physically.
+   virtualCube.Flatten();
+   ASSERT_EQ(virtualCube.GetOrientation(), 0);
+   ASSERT_EQ(cube.GetFaceData(), virtualCube.GetFaceData());
+}
+
+TEST(HashTest, StateTests)
+{
+   Cube solved;
+   Cube cube;
+   ASSERT_TRUE(cube == solved);
+   ASSERT_EQ(cube.Hash(), solved.Hash());
+
+   // A move and its inverse come back to an equal state with an equal hash.
+   cube.ExecuteMove(eCubeMove::Right);
+   ASSERT_FALSE(cube == solved);
+   ASSERT_NE(cube.Hash(), solved.Hash());
+   cube.ExecuteMove(eCubeMove::RightPrime);
+   ASSERT_TRUE(cube == solved);
+   ASSERT_EQ(cube.Hash(), solved.Hash());
+
+   // Virtual and physical orientations of the same state compare and hash the same.
+   Cube virtualCube;
+   virtualCube.SetVirtualRotations(true);
+   Cube physicalCube;
+   for (eCubeMove move : { eCubeMove::Right, eCubeMove::X, eCubeMove::Up, eCubeMove::ZPrime })
+   {
+      virtualCube.ExecuteMove(move);
+      physicalCube.ExecuteMove(move);
+   }
+
+   ASSERT_NE(virtualCube.GetOrientation(), 0);
+   ASSERT_TRUE(virtualCube == physicalCube);
+   ASSERT_EQ(virtualCube.Hash(), physicalCube.Hash());
+
+   // Every state reachable in two quarter or half turns is distinct, the hashes should be too.
+   std::unordered_set<Cube> states;
+   std::unordered_set<uint64_t> hashes;
+   for (int i = 0; i < EnumToInt(eCubeMove::NumMoves); i++)
+   {
+      for (int j = 0; j < EnumToInt(eCubeMove::NumMoves); j++)
+      {
+         Cube state;
+         state.ExecuteMove(static_cast<eCubeMove>(i));
+         state.ExecuteMove(static_cast<eCubeMove>(j));
+         if (states.insert(state).second)
+         {
+            hashes.insert(state.Hash());
+         }
+      }
+   }
+
+   ASSERT_GT(states.size(), 1u);
+   ASSERT_EQ(states.size(), hashes.size());
+}
+
+TEST(SymmetryTest, StateTests)
+{
+   std::mt19937 engine(7);
+   std::uniform_int_distribution<int> randomMovesGen(0, EnumToInt(eCubeMove::NumMoves) - 1);
+
+   std::vector<eCubeMove> scramble;
+   Cube::GenerateScramble(scramble, 25, 7);
+   Cube scrambled;
+   scrambled.ExecuteMoves(scramble.data(), scramble.size());
+
+   Cube canonical = scrambled;
+   canonical.Canonicalize();
+
+   // A solved cube is its own representative.
+   Cube solved;
+   ASSERT_EQ(solved.Canonicalize(), 0);
+   ASSERT_TRUE(solved.IsSolved());
+
+   for (int symmetry = 0; symmetry < NumSymmetries; symmetry++)
+   {
+      // Undoing the symmetry gets the original back.
+      Cube conjugated = scrambled;
+      conjugated.ApplySymmetry(symmetry);
+      Cube restored = conjugated;
+      restored.ApplySymmetry(Cube::InverseSymmetry(symmetry));
+      ASSERT_TRUE(restored == scrambled);
+
+      // Every equivalent state has the same representative, reached by the returned symmetry.
+      Cube representative = conjugated;
+      int applied = representative.Canonicalize();
+      ASSERT_TRUE(representative == canonical);
+      Cube check = conjugated;
+      check.ApplySymmetry(applied);
+      ASSERT_TRUE(check == canonical);
+
+      // Conjugated moves commute with the symmetry.
+      eCubeMove move = static_cast<eCubeMove>(randomMovesGen(engine));
+      Cube movedThenConjugated = scrambled;
+      movedThenConjugated.ExecuteMove(move);
+      movedThenConjugated.ApplySymmetry(symmetry);
+      conjugated.ExecuteMove(Cube::ConjugateMove(move, symmetry));
+      ASSERT_TRUE(conjugated == movedThenConjugated);
+   }
+
+   // A solution of the representative, conjugated back, solves the original.
+   Cube representative = scrambled;
+   int applied = representative.Canonicalize();
+   std::vector<eCubeMove> conjugatedScramble;
+   for (eCubeMove move : scramble)
+   {
+      conjugatedScramble.push_back(Cube::ConjugateMove(move, applied));
+   }
+
+   std::vector<eCubeMove> solution;
+   Cube::ReverseMoves(conjugatedScramble, solution);
+   representative.ExecuteMoves(solution.data(), solution.size());
+   ASSERT_TRUE(representative.IsSolved());
+
+   for (eCubeMove& move : solution)
+   {
+      move = Cube::ConjugateMove(move, Cube::InverseSymmetry(applied));
+   }
+
+   scrambled.ExecuteMoves(solution.data(), solution.size());
+   ASSERT_TRUE(scrambled.IsSolved());
+}
+
 int main(int argc, char** argv)
 {
    testing::InitGoogleTest(&argc, argv);
    return RUN_ALL_TESTS();
-}
\ No newline at end of file
+}
+
+/**
+ * @brief      Checks every piece against a scan of the stickers: the index has to find each one
+ * where its colors are, with its reference sticker showing the reference color.
+ */
+static void ExpectPieceIndexMatchesStickers(const Cube& cube)
+{
+   for (int sticker = 0; sticker < NumCubeStickers; sticker++)
+   {
+      std::array<int, 3> pieceStickers = {};
+      int numStickers = GetPieceStickers(GetStickerGeometry(sticker).Position, pieceStickers);
+      if (numStickers < 2)
+      {
+         continue;
+      }
+
+      std::array<eCubeColor, 3> colors = {};
+      for (int i = 0; i < numStickers; i++)
+      {
+         int seen = pieceStickers[i];
+         colors[i] = cube.GetState(static_cast<eCubeFace>(seen / (CubeSize * CubeSize)),
+            seen % (CubeSize * CubeSize) % CubeSize, seen % (CubeSize * CubeSize) / CubeSize);
+      }
+
+      eCubeFace face = static_cast<eCubeFace>(sticker / (CubeSize * CubeSize));
+      int x = sticker % (CubeSize * CubeSize) % CubeSize;
+      int y = sticker % (CubeSize * CubeSize) / CubeSize;
+
+      eCubeFace foundFace;
+      int foundX, foundY;
+      if (numStickers == 2)
+      {
+         ASSERT_TRUE(cube.IsPieceAt(colors[0], colors[1], face, x, y));
+         ASSERT_TRUE(cube.LocatePiece(colors[1], colors[0], foundFace, foundX, foundY));
+      }
+      else
+      {
+         ASSERT_TRUE(cube.IsPieceAt(colors[2], colors[0], colors[1], face, x, y));
+         ASSERT_TRUE(cube.LocatePiece(colors[0], colors[1], colors[2], foundFace, foundX, foundY));
+      }
+
+      // The located sticker is one of this piece's stickers.
+      int found = EnumToInt(foundFace) * CubeSize * CubeSize + CubeDimsToIdx(foundX, foundY);
+      bool isPieceSticker = false;
+      for (int i = 0; i < numStickers; i++)
+      {
+         isPieceSticker |= pieceStickers[i] == found;
+      }
+
+      ASSERT_TRUE(isPieceSticker);
+   }
+}
+
+TEST(PieceIndexTest, StateTests)
+{
+   std::mt19937 engine(11);
+   std::uniform_int_distribution<int> randomMovesGen(0, EnumToInt(eCubeMove::NumMoves) - 1);
+
+   // The reference stickers of a solved cube are where the top and bottom colors are.
+   Cube cube;
+   cube.SetPieceTracking(true);
+   eCubeFace face;
+   int x, y;
+   ASSERT_TRUE(cube.LocatePiece(eCubeColor::Green, eCubeColor::Yellow, face, x, y));
+   ASSERT_EQ(face, eCubeFace::Top);
+   ASSERT_EQ(cube.GetState(face, x, y), eCubeColor::Yellow);
+   ASSERT_TRUE(cube.IsPieceAt(eCubeColor::Yellow, eCubeColor::Green, eCubeFace::Front, 1, 0));
+   ASSERT_FALSE(cube.IsPieceAt(eCubeColor::Yellow, eCubeColor::Green, eCubeFace::Front, 1, 2));
+   ASSERT_TRUE(cube.LocatePiece(eCubeColor::Red, eCubeColor::Green, face, x, y));
+   ASSERT_EQ(face, eCubeFace::Front);
+
+   // Colors that don't make a piece are never found.
+   ASSERT_FALSE(cube.LocatePiece(eCubeColor::White, eCubeColor::Yellow, face, x, y));
+
+   // Kept up to date by moves, with and without virtual rotations, and by compiled algorithms.
+   Cube virtualCube;
+   virtualCube.SetVirtualRotations(true);
+   virtualCube.SetPieceTracking(true);
+   for (int i = 0; i < 300; i++)
+   {
+      eCubeMove move = static_cast<eCubeMove>(randomMovesGen(engine));
+      cube.ExecuteMove(move);
+      virtualCube.ExecuteMove(move);
+      ExpectPieceIndexMatchesStickers(cube);
+      ExpectPieceIndexMatchesStickers(virtualCube);
+   }
+
+   std::vector<eCubeMove> moves;
+   Cube::GenerateScramble(moves, 30, 11);
+   CompiledAlgorithm algorithm(moves);
+   cube.ExecuteAlgorithm(algorithm);
+   virtualCube.ExecuteAlgorithm(algorithm);
+   ExpectPieceIndexMatchesStickers(cube);
+   ExpectPieceIndexMatchesStickers(virtualCube);
+
+   // Rebuilt when the stickers are replaced.
+   virtualCube.Flatten();
+   ExpectPieceIndexMatchesStickers(virtualCube);
+   cube.SetSolved();
+   ExpectPieceIndexMatchesStickers(cube);
+
+   // Updated sticker by sticker, through an orientation, while pieces are briefly duplicated.
+   virtualCube.ExecuteMove(eCubeMove::Y);
+   for (int face = 0; face < EnumToInt(eCubeFace::NumFaces); face++)
+   {
+      for (int i = 0; i < CubeSize * CubeSize; i++)
+      {
+         eCubeFace cubeFace = static_cast<eCubeFace>(face);
+         eCubeColor color = virtualCube.GetState(cubeFace, i % CubeSize, i / CubeSize);
+         cube.SetState(cubeFace, i % CubeSize, i / CubeSize, color);
+      }
+   }
+
+   ASSERT_TRUE(cube == virtualCube);
+   ExpectPieceIndexMatchesStickers(cube);
+}
+
+TEST(SnapshotTest, StateTests)
+{
+   std::vector<eCubeMove> scramble;
+   Cube::GenerateScramble(scramble, 25, 3);
+
+   Cube cube;
+   cube.SetVirtualRotations(true);
+   cube.SetPieceTracking(true);
+   cube.ExecuteMoves(scramble.data(), scramble.size());
+   cube.ExecuteMove(eCubeMove::X);
+   Cube saved = cube;
+
+   tCubeSnapshot snapshot;
+   cube.SaveSnapshot(snapshot);
+
+   // Restores every sticker, the orientation and the piece index.
+   std::vector<eCubeMove> moves;
+   Cube::GenerateScramble(moves, 40, 4);
+   cube.ExecuteMoves(moves.data(), moves.size());
+   cube.ExecuteMove(eCubeMove::ZPrime);
+   ASSERT_FALSE(cube == saved);
+   cube.RestoreSnapshot(snapshot);
+   ASSERT_TRUE(cube == saved);
+   ASSERT_EQ(cube.GetOrientation(), saved.GetOrientation());
+   ExpectPieceIndexMatchesStickers(cube);
+
+   // A snapshot taken without the piece index rebuilds it when restored into a tracking cube.
+   Cube untracked;
+   untracked.ExecuteMoves(scramble.data(), scramble.size());
+   untracked.SaveSnapshot(snapshot);
+   Cube tracked;
+   tracked.SetPieceTracking(true);
+   tracked.RestoreSnapshot(snapshot);
+   ASSERT_TRUE(tracked == untracked);
+   ExpectPieceIndexMatchesStickers(tracked);
+}
+
+TEST(MoveMetadataTest, StateTests)
+{
+   std::vector<eCubeMove> scramble;
+   Cube::GenerateScramble(scramble, 25, 9);
+   Cube scrambled;
+   scrambled.ExecuteMoves(scramble.data(), scramble.size());
+
+   for (int i = 0; i < NumMoves; i++)
+   {
+      eCubeMove move = static_cast<eCubeMove>(i);
+      const tMoveInfo& info = GetMoveInfo(move);
+      ASSERT_EQ(GetInverseMove(info.Inverse), move);
+      ASSERT_EQ(info.Axis, GetAxisOfFace(info.Face));
+
+      Cube cube = scrambled;
+      cube.ExecuteMove(move);
+      ASSERT_EQ(cube == scrambled, info.QuarterTurns == 0);
+      cube.ExecuteMove(info.Inverse);
+      ASSERT_TRUE(cube == scrambled);
+
+      // Only rotations move the centers.
+      Cube centers;
+      centers.ExecuteMove(move);
+      bool centersMoved = centers.ColorOfFace(eCubeFace::Top) != eCubeColor::Yellow ||
+                          centers.ColorOfFace(eCubeFace::Front) != eCubeColor::Green;
+      ASSERT_EQ(info.IsRotation, centersMoved && info.LayerMask == AllLayers);
+
+      // Commuting moves give the same cube in either order, the others never do.
+      for (int j = 0; j < NumMoves; j++)
+      {
+         eCubeMove other = static_cast<eCubeMove>(j);
+         Cube firstThenOther = scrambled;
+         firstThenOther.ExecuteMove(move);
+         firstThenOther.ExecuteMove(other);
+         Cube otherThenFirst = scrambled;
+         otherThenFirst.ExecuteMove(other);
+         otherThenFirst.ExecuteMove(move);
+         ASSERT_EQ(DoMovesCommute(move, other), firstThenOther == otherThenFirst);
+      }
+   }
+
+   // Scrambles never turn the same face twice in a row.
+   for (size_t i = 1; i < scramble.size(); i++)
+   {
+      ASSERT_NE(GetMoveInfo(scramble[i]).Face, GetMoveInfo(scramble[i - 1]).Face);
+   }
+}
+
+TEST(MoveBufferTest, StateTests)
+{
+   std::vector<eCubeMove> moves;
+   Cube::GenerateScramble(moves, 20, 6);
+
+   // Stays inline up to its capacity, then keeps every move on the heap.
+   MoveBuffer<8> buffer;
+   ASSERT_TRUE(buffer.IsEmpty());
+   buffer.Append(std::span<const eCubeMove>(moves).first(5));
+   buffer.Push(moves[5]);
+   ASSERT_FALSE(buffer.IsSpilled());
+   buffer.Append(std::span<const eCubeMove>(moves).subspan(6, 6));
+   buffer.Push(moves[12]);
+   ASSERT_TRUE(buffer.IsSpilled());
+   buffer.Append(std::span<const eCubeMove>(moves).subspan(13));
+   ASSERT_TRUE(std::ranges::equal(buffer.GetMoves(), moves));
+
+   // Shrinking back to the inline capacity brings the moves back inline.
+   buffer.Truncate(10);
+   buffer.Erase(0);
+   ASSERT_TRUE(buffer.IsSpilled());
+   buffer.Erase(0);
+   ASSERT_FALSE(buffer.IsSpilled());
+   ASSERT_TRUE(
+      std::ranges::equal(buffer.GetMoves(), std::span<const eCubeMove>(moves).subspan(2, 8)));
+   buffer.Truncate(3);
+   ASSERT_EQ(buffer.GetSize(), 3);
+
+   buffer.Clear();
+   ASSERT_TRUE(buffer.IsEmpty());
+   buffer.Push(moves[0]);
+   ASSERT_FALSE(buffer.IsSpilled());
+   ASSERT_EQ(buffer.GetMoves()[0], moves[0]);
+
+   // The move list records accepted moves only.
+   Cube cube;
+   CubeMoveList moveList(cube);
+   moveList.PushMoves(moves);
+   moveList.RejectPendingMoves();
+   ASSERT_TRUE(cube.IsSolved());
+   ASSERT_EQ(moveList.GetNumMoves(), 0);
+
+   std::vector<eCubeMove> fewMoves(moves.begin(), moves.begin() + 2);
+   moveList.PushMoves(fewMoves, true);
+   moveList.PushMove(eCubeMove::Up);
+   moveList.RejectPendingMoves();
+   ASSERT_TRUE(std::ranges::equal(moveList.GetMoves(), fewMoves));
+}
+
+/**
+ * @brief      Accepts the given moves one by one and returns the recorded moves as notation.
+ */
+static std::string CanonicalMoves(const std::string& notation)
+{
+   std::vector<eCubeMove> moves;
+   Cube::ParseMoveNotation(notation, moves);
+
+   Cube cube;
+   CubeMoveList moveList(cube);
+   for (eCubeMove move : moves)
+   {
+      moveList.PushMove(move, true);
+   }
+
+   std::ostringstream stream;
+   moveList.SerializeMoves(stream);
+   return stream.str();
+}
+
+TEST(MoveCancellationTest, StateTests)
+{
+   ASSERT_EQ(CanonicalMoves("U U'"), "");
+   ASSERT_EQ(CanonicalMoves("R R"), CanonicalMoves("R2"));
+   ASSERT_EQ(CanonicalMoves("U2 U"), CanonicalMoves("U'"));
+   ASSERT_EQ(CanonicalMoves("x x x"), CanonicalMoves("x'"));
+   ASSERT_EQ(CanonicalMoves("R U U' R'"), "");
+
+   // Moves are carried back past commuting moves to find their match.
+   ASSERT_EQ(CanonicalMoves("U D U'"), CanonicalMoves("D"));
+   ASSERT_EQ(CanonicalMoves("R L2 R"), CanonicalMoves("L2 R2"));
+   ASSERT_EQ(CanonicalMoves("M2 E2 M2"), CanonicalMoves("E2"));
+   ASSERT_EQ(CanonicalMoves("M E2 M2"), CanonicalMoves("M' E2"));
+   ASSERT_NE(CanonicalMoves("M2 E2 M"), CanonicalMoves("M' E2"));
+
+   // Moves that don't commute block each other, and different layers never merge.
+   ASSERT_NE(CanonicalMoves("F R L F'"), CanonicalMoves("R L"));
+   ASSERT_NE(CanonicalMoves("R Rw'"), "");
+
+   // The recorded moves always do the same as the executed ones.
+   std::mt19937 engine(21);
+   std::uniform_int_distribution<int> randomMovesGen(0, EnumToInt(eCubeMove::NumMoves) - 1);
+   for (int trial = 0; trial < 50; trial++)
+   {
+      Cube cube;
+      CubeMoveList moveList(cube);
+      for (int i = 0; i < 40; i++)
+      {
+         moveList.PushMove(static_cast<eCubeMove>(randomMovesGen(engine)), i % 3 == 2);
+      }
+
+      moveList.AcceptPendingMoves();
+      std::span<const eCubeMove> recorded = moveList.GetMoves();
+      ASSERT_LE(recorded.size(), 40);
+
+      Cube replayed;
+      replayed.ExecuteMoves(recorded);
+      ASSERT_TRUE(replayed == cube);
+      for (size_t i = 1; i < recorded.size(); i++)
+      {
+         eCubeMove merged;
+         ASSERT_FALSE(MergeMoves(recorded[i - 1], recorded[i], merged));
+      }
+   }
+}
+
+TEST(SavepointTest, StateTests)
+{
+   std::vector<eCubeMove> scramble;
+   Cube::GenerateScramble(scramble, 20, 22);
+
+   Cube cube;
+   cube.SetVirtualRotations(true);
+   cube.SetPieceTracking(true);
+   CubeMoveList moveList(cube);
+   moveList.PushMoves(scramble, true);
+   Cube accepted = cube;
+
+   // Nested branches, each rolled back on its own.
+   moveList.PushMove(eCubeMove::Right);
+   Cube outer = cube;
+   size_t outerSavepoint = moveList.CreateSavepoint();
+   moveList.PushMove(eCubeMove::Up);
+   Cube inner = cube;
+   size_t innerSavepoint = moveList.CreateSavepoint();
+   ASSERT_EQ(moveList.GetNumSavepoints(), 2);
+
+   moveList.PushMoves(scramble);
+   moveList.PushMove(eCubeMove::Y);
+   moveList.RollbackToSavepoint(innerSavepoint);
+   ASSERT_TRUE(cube == inner);
+   ASSERT_EQ(moveList.GetNumPendingMoves(), 2);
+   ExpectPieceIndexMatchesStickers(cube);
+
+   // Rolling back to the outer savepoint releases the inner one.
+   moveList.PushMove(eCubeMove::Front);
+   moveList.RollbackToSavepoint(outerSavepoint);
+   ASSERT_TRUE(cube == outer);
+   ASSERT_EQ(moveList.GetNumSavepoints(), 1);
+   ASSERT_EQ(moveList.GetNumPendingMoves(), 1);
+
+   // Releasing keeps the moves of the branch pending.
+   moveList.PushMove(eCubeMove::Down);
+   moveList.ReleaseSavepoint(outerSavepoint);
+   ASSERT_EQ(moveList.GetNumSavepoints(), 0);
+   ASSERT_EQ(moveList.GetNumPendingMoves(), 2);
+
+   // Rejecting still goes back to before the first pending move.
+   moveList.CreateSavepoint();
+   moveList.RejectPendingMoves();
+   ASSERT_TRUE(cube == accepted);
+   ASSERT_EQ(moveList.GetNumSavepoints(), 0);
+   ASSERT_EQ(moveList.GetNumPendingMoves(), 0);
+}
+
+TEST(NotationParserTest, StateTests)
+{
+   // Every move comes back from its notation, in every spelling.
+   for (int i = 0; i < NumMoves; i++)
+   {
+      eCubeMove move = static_cast<eCubeMove>(i);
+      std::ostringstream stream;
+      Cube::SerializeMoveList(stream, &move, 1);
+
+      std::array<eCubeMove, 2> buffer;
+      tNotationResult result = Cube::ParseMoveNotation(stream.str(), buffer);
+      ASSERT_EQ(result.Error, eNotationError::None);
+      ASSERT_EQ(result.NumMoves, 1);
+      ASSERT_EQ(buffer[0], move);
+   }
+
+   std::array<eCubeMove, 8> buffer;
+   tNotationResult result = Cube::ParseMoveNotation("(r' Dw2)-u,x'", buffer);
+   ASSERT_EQ(result.Error, eNotationError::None);
+   ASSERT_EQ(result.NumMoves, 4);
+   ASSERT_EQ(buffer[0], eCubeMove::RightWidePrime);
+   ASSERT_EQ(buffer[1], eCubeMove::DownWide2);
+   ASSERT_EQ(buffer[2], eCubeMove::UpWide);
+   ASSERT_EQ(buffer[3], eCubeMove::XPrime);
+
+   // Errors point at the token and keep the moves before it.
+   result = Cube::ParseMoveNotation("R U R2' U'", buffer);
+   ASSERT_EQ(result.Error, eNotationError::InvalidMove);
+   ASSERT_EQ(result.NumMoves, 2);
+   ASSERT_EQ(result.ErrorOffset, 4);
+   ASSERT_EQ(result.ErrorLength, 3);
+
+   result = Cube::ParseMoveNotation("uw Mw", buffer);
+   ASSERT_EQ(result.Error, eNotationError::InvalidMove);
+   ASSERT_EQ(result.NumMoves, 0);
+
+   result = Cube::ParseMoveNotation("R U R' U'", std::span<eCubeMove>(buffer).first(3));
+   ASSERT_EQ(result.Error, eNotationError::BufferTooSmall);
+   ASSERT_EQ(result.NumMoves, 3);
+   ASSERT_EQ(result.ErrorOffset, 7);
+
+   // The vector version skips invalid moves, reports the first one and keeps going.
+   std::vector<eCubeMove> moves = { eCubeMove::Y };
+   result = Cube::ParseMoveNotation("R RU U2 Q2' x", moves);
+   ASSERT_EQ(moves, std::vector<eCubeMove>({ eCubeMove::Y, eCubeMove::Right, eCubeMove::Up2,
+                                             eCubeMove::X }));
+   ASSERT_EQ(result.NumMoves, 3);
+   ASSERT_EQ(result.Error, eNotationError::InvalidMove);
+   ASSERT_EQ(result.ErrorOffset, 2);
+   ASSERT_EQ(result.ErrorLength, 2);
+   ASSERT_EQ(result.NumSkippedMoves, 2);
+
+   // Nothing is allocated, so the parser also runs at compile time.
+   constexpr auto parsed = []()
+   {
+      std::array<eCubeMove, 3> result = {};
+      return std::pair(cube::ParseMoveNotation("M2 E' S", result), result);
+   }();
+   static_assert(parsed.first.NumMoves == 3 && parsed.second[2] == eCubeMove::Standing);
+
+   // Literals are parsed into an array of the exact size, invalid notation doesn't compile.
+   constexpr auto literal = "(R U R')y'"_moves;
+   static_assert(literal.size() == 4 && literal[3] == eCubeMove::YPrime);
+   static_assert(""_moves.empty());
+}
+
+TEST(MoveSerializerTest, StateTests)
+{
+   constexpr auto moves = "R Uw' M2 x y' z2 B"_moves;
+   std::array<char, GetMaxSerializedLength(moves.size())> buffer;
+   size_t length = Cube::SerializeMoveList(moves, buffer);
+   ASSERT_EQ(std::string_view(buffer.data(), length), "R Uw' M2 x y' z2 B ");
+
+   length = Cube::SerializeMoveList(moves, buffer, true);
+   ASSERT_EQ(std::string_view(buffer.data(), length), "R Uw' M2 x y' - z2 B ");
+
+   // Only whole moves are written.
+   length = Cube::SerializeMoveList(moves, std::span<char>(buffer).first(7));
+   ASSERT_EQ(std::string_view(buffer.data(), length), "R Uw' ");
+
+   // The stream version matches, separators included across its internal blocks.
+   std::vector<eCubeMove> scramble;
+   Cube::GenerateScramble(scramble, 1000, 7);
+   for (bool includeSeparators : { false, true })
+   {
+      std::ostringstream stream;
+      Cube::SerializeMoveList(stream, scramble.data(), scramble.size(), includeSeparators);
+
+      std::vector<char> serialized(GetMaxSerializedLength(scramble.size()));
+      length = Cube::SerializeMoveList(scramble, serialized, includeSeparators);
+      ASSERT_EQ(stream.str(), std::string_view(serialized.data(), length));
+
+      std::vector<eCubeMove> parsed;
+      Cube::ParseMoveNotation(stream.str(), parsed);
+      ASSERT_EQ(parsed, scramble);
+   }
+}